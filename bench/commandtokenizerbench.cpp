@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "commandtokenizer.h"
+#include "allocationcounter.h"
+
+std::vector<std::string> legacyCommandSplicer(const std::string& command) {
+    std::vector<std::string> commands;
+    std::istringstream iss(command);
+    std::string word;
+    std::string combined;
+    bool inQuotes = false;
+    char quoteChar = '\0';
+
+    while (iss >> word) {
+        if (!inQuotes && (word.front() == '\'' || word.front() == '"' || word.front() == '(' || word.front() == '[')) {
+            inQuotes = true;
+            quoteChar = word.front();
+            combined = word.substr(1);
+        } else if (inQuotes && word.back() == quoteChar) {
+            combined += " " + word.substr(0, word.size() - 1);
+            commands.push_back(combined);
+            inQuotes = false;
+            quoteChar = '\0';
+        } else if (inQuotes) {
+            combined += " " + word;
+        } else {
+            commands.push_back(word);
+        }
+    }
+
+    if (inQuotes) {
+        commands.push_back(combined);
+    }
+
+    return commands;
+}
+
+std::vector<std::string> generateLines(size_t count, bool quoted) {
+    const std::vector<std::string> words = {
+        "user", "data", "get", "userhistory", "--since", "yesterday", "--grep", "make", "ai", "file", "add",
+        "src/main.cpp", "shortcut", "list", "startup", "runall", "terminal", "git", "status", "--tail", "20"
+    };
+    std::mt19937 random(42);
+    std::vector<std::string> lines;
+    lines.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        std::string line;
+        int length = 2 + random() % 6;
+        for (int w = 0; w < length; w++) {
+            line += (w == 0 ? "" : " ") + words[random() % words.size()];
+        }
+        if (quoted) {
+            line += " \"" + words[random() % words.size()] + " " + words[random() % words.size()] + "\"";
+        }
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+int main(int argc, char* argv[]) {
+    size_t lineCount = argc > 1 ? std::stoul(argv[1]) : 100000;
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 10;
+
+    std::cout << "Lines: " << lineCount << ", iterations: " << iterations << std::endl;
+    std::cout << std::left << std::setw(10) << "input" << std::setw(14) << "splicer (ns)" << std::setw(16) << "tokenizer (ns)"
+              << std::setw(18) << "splicer allocs" << std::setw(18) << "tokenizer allocs" << "speedup" << std::endl;
+
+    bool resultsMatch = true;
+    for (bool quoted : {false, true}) {
+        std::vector<std::string> lines = generateLines(lineCount, quoted);
+        size_t checksum = 0;
+
+        uint64_t allocationsBefore = AllocationCounter::getCount();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            for (const auto& line : lines) {
+                checksum += legacyCommandSplicer(line).size();
+            }
+        }
+        double splicerTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        uint64_t splicerAllocations = AllocationCounter::getCount() - allocationsBefore;
+
+        CommandTokenizer tokenizer;
+        allocationsBefore = AllocationCounter::getCount();
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            for (const auto& line : lines) {
+                checksum -= tokenizer.tokenize(line).size();
+            }
+        }
+        double tokenizerTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        uint64_t tokenizerAllocations = AllocationCounter::getCount() - allocationsBefore;
+
+        for (const auto& line : lines) {
+            std::vector<std::string> expected = legacyCommandSplicer(line);
+            const std::pmr::vector<std::string_view>& tokens = tokenizer.tokenize(line);
+            if (expected.size() != tokens.size() || !std::equal(expected.begin(), expected.end(), tokens.begin())) {
+                resultsMatch = false;
+            }
+        }
+
+        double runs = static_cast<double>(lineCount) * iterations;
+        std::cout << std::setw(10) << (quoted ? "quoted" : "plain") << std::fixed << std::setprecision(1)
+                  << std::setw(14) << splicerTime / runs << std::setw(16) << tokenizerTime / runs
+                  << std::setprecision(3) << std::setw(18) << splicerAllocations / runs << std::setw(18) << tokenizerAllocations / runs
+                  << std::setprecision(2) << splicerTime / tokenizerTime << "x" << (checksum == 0 ? "" : " (token counts differ)") << std::endl;
+    }
+    CommandTokenizer tokenizer;
+    const std::vector<std::pair<std::string, bool>> apostropheLines = {
+        {"ai chat \"what's up\"", true}, {"ai chat 'it is' done", true}, {"ai chat what's up", false}
+    };
+    for (const auto& [line, complete] : apostropheLines) {
+        std::vector<std::string> expected = legacyCommandSplicer(line);
+        const std::pmr::vector<std::string_view>& tokens = tokenizer.tokenize(line);
+        bool equal = expected.size() == tokens.size() && std::equal(expected.begin(), expected.end(), tokens.begin());
+        if (tokenizer.isComplete() != complete || (complete && !equal)) {
+            resultsMatch = false;
+        }
+    }
+    if (!resultsMatch) {
+        std::cerr << "Error: the tokenizer disagrees with the legacy splicer." << std::endl;
+        return 1;
+    }
+    return 0;
+}
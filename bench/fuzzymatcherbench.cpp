@@ -0,0 +1,84 @@
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include "fuzzymatcher.h"
+
+std::vector<std::string> generateCandidates(size_t count) {
+    const std::vector<std::string> segments = {
+        "src", "include", "build", "test", "lib", "docs", "assets", "scripts", "config", "vendor",
+        "terminal", "passthrough", "prompt", "engine", "history", "index", "matcher", "parser",
+        "Session", "CommandRegistry", "utils", "network", "cache", "render", "main", "daemon"
+    };
+    const std::vector<std::string> extensions = {".cpp", ".h", ".txt", ".json", ".md", ".py", ".sh"};
+    std::mt19937 random(42);
+    std::vector<std::string> candidates;
+    candidates.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        std::string path;
+        int depth = 1 + random() % 5;
+        for (int d = 0; d < depth; d++) {
+            path += segments[random() % segments.size()] + "/";
+        }
+        path += segments[random() % segments.size()] + "_" + std::to_string(random() % 1000);
+        path += extensions[random() % extensions.size()];
+        candidates.push_back(path);
+    }
+    return candidates;
+}
+
+int main(int argc, char* argv[]) {
+    size_t candidateCount = argc > 1 ? std::stoul(argv[1]) : 300000;
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 5;
+    std::vector<std::string> candidates = generateCandidates(candidateCount);
+    const std::vector<std::string> queries = {"m", "src", "tpe", "histidx", "CommandRegistry", "sessdmn.cpp", "zzzq"};
+
+    std::vector<FuzzyMatcher::Kernel> kernels = {FuzzyMatcher::Kernel::Scalar};
+    if (FuzzyMatcher::detectKernel() != FuzzyMatcher::Kernel::Scalar) {
+        kernels.push_back(FuzzyMatcher::Kernel::SSE2);
+    }
+    if (FuzzyMatcher::detectKernel() == FuzzyMatcher::Kernel::AVX2) {
+        kernels.push_back(FuzzyMatcher::Kernel::AVX2);
+    }
+
+    std::cout << "Candidates: " << candidateCount << ", iterations: " << iterations << std::endl;
+    std::cout << std::left << std::setw(18) << "query";
+    for (auto kernel : kernels) {
+        std::cout << std::setw(14) << FuzzyMatcher::getKernelName(kernel) + " (ms)";
+    }
+    std::cout << "speedup" << std::endl;
+
+    bool resultsMatch = true;
+    for (const auto& query : queries) {
+        std::cout << std::setw(18) << query;
+        std::vector<double> timings;
+        std::vector<FuzzyMatch> baseline;
+        for (auto kernel : kernels) {
+            FuzzyMatcher matcher(kernel);
+            matcher.setQuery(query);
+            std::vector<FuzzyMatch> results;
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; i++) {
+                results = matcher.rank(candidates, 10);
+            }
+            auto end = std::chrono::steady_clock::now();
+            double elapsed = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+            timings.push_back(elapsed);
+            if (kernel == FuzzyMatcher::Kernel::Scalar) {
+                baseline = results;
+            } else if (results.size() != baseline.size() || !std::equal(results.begin(), results.end(), baseline.begin(),
+                           [](const FuzzyMatch& a, const FuzzyMatch& b) { return a.index == b.index && a.score == b.score; })) {
+                resultsMatch = false;
+            }
+            std::cout << std::setw(14) << std::fixed << std::setprecision(3) << elapsed;
+        }
+        std::cout << std::setprecision(2) << timings.front() / timings.back() << "x" << std::endl;
+    }
+    if (!resultsMatch) {
+        std::cerr << "Error: vectorized kernels disagree with the scalar scorer." << std::endl;
+        return 1;
+    }
+    return 0;
+}
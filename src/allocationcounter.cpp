@@ -0,0 +1,37 @@
+#include "allocationcounter.h"
+#include <cstdlib>
+#include <new>
+
+static thread_local uint64_t allocationCount = 0;
+
+uint64_t AllocationCounter::getCount() {
+    return allocationCount;
+}
+
+void* operator new(std::size_t size) {
+    allocationCount++;
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
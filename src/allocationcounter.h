@@ -0,0 +1,10 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+#include <cstdint>
+
+class AllocationCounter {
+public:
+    static uint64_t getCount();
+};
+
+#endif // ALLOCATIONCOUNTER_H
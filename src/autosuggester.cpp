@@ -0,0 +1,210 @@
+#include "autosuggester.h"
+#include <algorithm>
+
+AutoSuggester::AutoSuggester() {}
+
+void AutoSuggester::update(const MappedHistory& history) {
+    if (loaded && history.getFileId() == historyId && history.size() >= consumedRecords) {
+        HistoryRecord record;
+        for (; consumedRecords < history.size(); consumedRecords++) {
+            if (history.getRecord(consumedRecords, record)) {
+                addRecord(record);
+            }
+        }
+        return;
+    }
+    std::unordered_map<std::string, Entry> aggregated;
+    HistoryRecord record;
+    for (size_t i = 0; i < history.size(); i++) {
+        if (!history.getRecord(i, record) || record.command.empty()) {
+            continue;
+        }
+        Entry& entry = aggregated[record.command];
+        entry.count += record.count;
+        entry.lastUsed = std::max(entry.lastUsed, record.timestamp);
+        if (!record.directory.empty()) {
+            recordDirectory(entry, getDirectoryId(record.directory));
+        }
+    }
+    historyId = history.getFileId();
+    consumedRecords = history.size();
+    entries.clear();
+    entries.reserve(aggregated.size());
+    for (auto& [command, entry] : aggregated) {
+        entry.command = command;
+        entries.push_back(std::move(entry));
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.command < b.command;
+    });
+    rebuild();
+    loaded = true;
+}
+
+void AutoSuggester::addRecord(const HistoryRecord& record) {
+    if (record.command.empty()) {
+        return;
+    }
+    auto it = std::lower_bound(entries.begin(), entries.end(), record.command, [](const Entry& entry, const std::string& value) {
+        return entry.command < value;
+    });
+    if (it != entries.end() && it->command == record.command) {
+        it->count += record.count;
+        it->lastUsed = std::max(it->lastUsed, record.timestamp);
+        if (!record.directory.empty()) {
+            recordDirectory(*it, getDirectoryId(record.directory));
+        }
+        updateScore(it - entries.begin(), it->lastUsed);
+        return;
+    }
+    Entry entry;
+    entry.command = record.command;
+    entry.count = record.count;
+    entry.lastUsed = record.timestamp;
+    if (!record.directory.empty()) {
+        recordDirectory(entry, getDirectoryId(record.directory));
+    }
+    entries.insert(it, std::move(entry));
+    rebuild();
+}
+
+std::string AutoSuggester::suggest(const std::string& prefix, const std::string& directory) {
+    if (!loaded || prefix.empty() || entries.empty()) {
+        return "";
+    }
+    narrowTo(prefix);
+    auto [first, last] = prefixRanges.back();
+    if (first < last && entries[first].command.size() == prefix.size()) {
+        first++;
+    }
+    if (first >= last) {
+        return "";
+    }
+    size_t best = first;
+    if (last - first <= DIRECTORY_RANKING_LIMIT) {
+        auto found = directoryIds.find(directory);
+        double bestScore = -1;
+        for (size_t i = first; i < last; i++) {
+            double score = entries[i].score;
+            if (found != directoryIds.end() &&
+                std::find(entries[i].directories.begin(), entries[i].directories.end(), found->second) != entries[i].directories.end()) {
+                score *= 2;
+            }
+            if (score > bestScore) {
+                bestScore = score;
+                best = i;
+            }
+        }
+    } else {
+        best = bestInRange(first, last);
+    }
+    return entries[best].command;
+}
+
+void AutoSuggester::rebuild() {
+    time_t now = time(nullptr);
+    size_t n = entries.size();
+    for (auto& entry : entries) {
+        entry.score = frecency(entry, now);
+    }
+    bestTree.assign(2 * n, 0);
+    for (size_t i = 0; i < n; i++) {
+        bestTree[n + i] = static_cast<uint32_t>(i);
+    }
+    for (size_t i = n; i-- > 1;) {
+        bestTree[i] = isBetter(bestTree[2 * i], bestTree[2 * i + 1]) ? bestTree[2 * i] : bestTree[2 * i + 1];
+    }
+    currentPrefix.clear();
+    prefixRanges.assign(1, {0, n});
+}
+
+void AutoSuggester::updateScore(size_t index, time_t now) {
+    size_t n = entries.size();
+    entries[index].score = frecency(entries[index], now);
+    for (size_t i = (n + index) / 2; i >= 1; i /= 2) {
+        bestTree[i] = isBetter(bestTree[2 * i], bestTree[2 * i + 1]) ? bestTree[2 * i] : bestTree[2 * i + 1];
+    }
+}
+
+void AutoSuggester::narrowTo(const std::string& prefix) {
+    size_t common = 0;
+    while (common < currentPrefix.size() && common < prefix.size() && currentPrefix[common] == prefix[common]) {
+        common++;
+    }
+    currentPrefix.resize(common);
+    prefixRanges.resize(common + 1);
+    for (size_t k = common; k < prefix.size(); k++) {
+        auto [first, last] = prefixRanges.back();
+        unsigned char c = static_cast<unsigned char>(prefix[k]);
+        auto begin = entries.begin() + first;
+        auto end = entries.begin() + last;
+        auto lower = std::partition_point(begin, end, [k, c](const Entry& entry) {
+            return entry.command.size() <= k || static_cast<unsigned char>(entry.command[k]) < c;
+        });
+        auto upper = std::partition_point(lower, end, [k, c](const Entry& entry) {
+            return static_cast<unsigned char>(entry.command[k]) == c;
+        });
+        prefixRanges.emplace_back(lower - entries.begin(), upper - entries.begin());
+        currentPrefix += prefix[k];
+    }
+}
+
+size_t AutoSuggester::bestInRange(size_t first, size_t last) const {
+    size_t n = entries.size();
+    uint32_t best = static_cast<uint32_t>(first);
+    for (size_t l = first + n, r = last + n; l < r; l /= 2, r /= 2) {
+        if (l & 1) {
+            if (isBetter(bestTree[l], best)) {
+                best = bestTree[l];
+            }
+            l++;
+        }
+        if (r & 1) {
+            r--;
+            if (isBetter(bestTree[r], best)) {
+                best = bestTree[r];
+            }
+        }
+    }
+    return best;
+}
+
+bool AutoSuggester::isBetter(uint32_t a, uint32_t b) const {
+    return entries[a].score > entries[b].score;
+}
+
+uint32_t AutoSuggester::getDirectoryId(const std::string& directory) {
+    auto it = directoryIds.find(directory);
+    if (it != directoryIds.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(directoryIds.size());
+    directoryIds.emplace(directory, id);
+    return id;
+}
+
+void AutoSuggester::recordDirectory(Entry& entry, uint32_t directoryId) {
+    auto it = std::find(entry.directories.begin(), entry.directories.end(), directoryId);
+    if (it != entry.directories.end()) {
+        entry.directories.erase(it);
+    }
+    entry.directories.insert(entry.directories.begin(), directoryId);
+    if (entry.directories.size() > MAX_DIRECTORIES_PER_ENTRY) {
+        entry.directories.pop_back();
+    }
+}
+
+double AutoSuggester::frecency(const Entry& entry, time_t now) {
+    double age = difftime(now, entry.lastUsed);
+    double weight;
+    if (age < 3600) {
+        weight = 4.0;
+    } else if (age < 86400) {
+        weight = 2.0;
+    } else if (age < 604800) {
+        weight = 1.0;
+    } else {
+        weight = 0.5;
+    }
+    return entry.count * weight;
+}
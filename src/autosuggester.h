@@ -0,0 +1,49 @@
+#ifndef AUTOSUGGESTER_H
+#define AUTOSUGGESTER_H
+#include <string>
+#include <vector>
+#include <ctime>
+#include <cstdint>
+#include <unordered_map>
+#include "mappedhistory.h"
+
+class AutoSuggester {
+public:
+    AutoSuggester();
+
+    void update(const MappedHistory& history);
+    std::string suggest(const std::string& prefix, const std::string& directory);
+
+private:
+    struct Entry {
+        std::string command;
+        uint32_t count = 0;
+        time_t lastUsed = 0;
+        std::vector<uint32_t> directories;
+        double score = 0;
+    };
+
+    void addRecord(const HistoryRecord& record);
+    void rebuild();
+    void updateScore(size_t index, time_t now);
+    void narrowTo(const std::string& prefix);
+    size_t bestInRange(size_t first, size_t last) const;
+    bool isBetter(uint32_t a, uint32_t b) const;
+    uint32_t getDirectoryId(const std::string& directory);
+    static void recordDirectory(Entry& entry, uint32_t directoryId);
+    static double frecency(const Entry& entry, time_t now);
+
+    std::vector<Entry> entries;
+    std::vector<uint32_t> bestTree;
+    std::unordered_map<std::string, uint32_t> directoryIds;
+    std::string currentPrefix;
+    std::vector<std::pair<size_t, size_t>> prefixRanges;
+    uint64_t historyId = 0;
+    size_t consumedRecords = 0;
+    bool loaded = false;
+
+    const size_t DIRECTORY_RANKING_LIMIT = 256;
+    static constexpr size_t MAX_DIRECTORIES_PER_ENTRY = 8;
+};
+
+#endif // AUTOSUGGESTER_H
@@ -0,0 +1,62 @@
+#include "commandarena.h"
+#include "allocationcounter.h"
+#include <algorithm>
+#include <cstdio>
+
+CommandArena::CommandArena() : arena(initialBuffer, sizeof(initialBuffer), std::pmr::new_delete_resource()) {}
+
+void CommandArena::begin() {
+    if (depth++ == 0) {
+        allocationsAtStart = AllocationCounter::getCount();
+    }
+}
+
+void CommandArena::end() {
+    if (--depth > 0) {
+        return;
+    }
+    lastAllocations = AllocationCounter::getCount() - allocationsAtStart;
+    totalAllocations += lastAllocations;
+    lastBytes = bytesUsed;
+    peakBytes = std::max(peakBytes, bytesUsed);
+    commandCount++;
+    arena.release();
+    bytesUsed = 0;
+}
+
+size_t CommandArena::getBytesUsed() const {
+    return bytesUsed;
+}
+
+std::string CommandArena::getSummary() const {
+    if (commandCount == 0) {
+        return "No commands recorded yet.";
+    }
+    char mean[32];
+    snprintf(mean, sizeof(mean), "%.2f", static_cast<double>(totalAllocations) / commandCount);
+    std::string summary = "Commands: " + std::to_string(commandCount) + "\n";
+    summary += "Heap allocations (last): " + std::to_string(lastAllocations) + "\n";
+    summary += "Heap allocations (mean): " + std::string(mean) + "\n";
+    summary += "Arena bytes (last):      " + std::to_string(lastBytes) + "\n";
+    summary += "Arena bytes (peak):      " + std::to_string(peakBytes);
+    return summary;
+}
+
+void CommandArena::resetStatistics() {
+    commandCount = 0;
+    lastAllocations = 0;
+    totalAllocations = 0;
+    lastBytes = 0;
+    peakBytes = 0;
+}
+
+void* CommandArena::do_allocate(size_t bytes, size_t alignment) {
+    bytesUsed += bytes;
+    return arena.allocate(bytes, alignment);
+}
+
+void CommandArena::do_deallocate(void*, size_t, size_t) {}
+
+bool CommandArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,39 @@
+#ifndef COMMANDARENA_H
+#define COMMANDARENA_H
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+class CommandArena : public std::pmr::memory_resource {
+public:
+    CommandArena();
+    CommandArena(const CommandArena&) = delete;
+    CommandArena& operator=(const CommandArena&) = delete;
+
+    void begin();
+    void end();
+    size_t getBytesUsed() const;
+    std::string getSummary() const;
+    void resetStatistics();
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    static constexpr size_t INITIAL_SIZE = 16 * 1024;
+
+    alignas(std::max_align_t) std::byte initialBuffer[INITIAL_SIZE];
+    std::pmr::monotonic_buffer_resource arena;
+    size_t bytesUsed = 0;
+    int depth = 0;
+    uint64_t allocationsAtStart = 0;
+    uint64_t commandCount = 0;
+    uint64_t lastAllocations = 0;
+    uint64_t totalAllocations = 0;
+    size_t lastBytes = 0;
+    size_t peakBytes = 0;
+};
+
+#endif // COMMANDARENA_H
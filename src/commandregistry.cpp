@@ -0,0 +1,393 @@
+#include "commandregistry.h"
+#include <iostream>
+#include <algorithm>
+#include <charconv>
+
+static std::string getHelpCommand(const std::string& path) {
+    return path.empty() ? "help" : path + " help";
+}
+
+static bool isOption(std::string_view name) {
+    return name.rfind("--", 0) == 0;
+}
+
+static std::string_view skipWords(std::string_view line, size_t count) {
+    const char* separators = " \t\r\n";
+    size_t position = line.find_first_not_of(separators);
+    for (size_t i = 0; i < count && position != std::string_view::npos; i++) {
+        position = line.find_first_not_of(separators, line.find_first_of(separators, position));
+    }
+    return position == std::string_view::npos ? std::string_view() : line.substr(position);
+}
+
+static bool isNumber(std::string_view text) {
+    uint64_t value;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && error == std::errc() && end == text.data() + text.size();
+}
+
+CommandArguments::CommandArguments(std::pmr::memory_resource* resource) : values(resource), bindings(resource), joined(resource) {}
+
+bool CommandArguments::has(std::string_view name) const {
+    return find(name) != nullptr;
+}
+
+std::string_view CommandArguments::get(std::string_view name) const {
+    const Binding* binding = find(name);
+    return binding == nullptr ? std::string_view() : binding->text;
+}
+
+uint64_t CommandArguments::getNumber(std::string_view name) const {
+    std::string_view text = get(name);
+    uint64_t value = 0;
+    std::from_chars(text.data(), text.data() + text.size(), value);
+    return value;
+}
+
+std::pmr::vector<std::string_view> CommandArguments::getList(std::string_view name) const {
+    std::pmr::vector<std::string_view> list(values.get_allocator());
+    if (const Binding* binding = find(name)) {
+        list.assign(values.begin() + binding->first, values.begin() + binding->first + binding->count);
+    }
+    return list;
+}
+
+std::string_view CommandArguments::getLine() const {
+    return line;
+}
+
+const CommandArguments::Binding* CommandArguments::find(std::string_view name) const {
+    for (const Binding& binding : bindings) {
+        if (binding.name == name) {
+            return &binding;
+        }
+    }
+    return nullptr;
+}
+
+void CommandArguments::bind(std::string_view name, std::string_view value, bool append) {
+    values.push_back(value);
+    for (Binding& binding : bindings) {
+        if (binding.name != name) {
+            continue;
+        }
+        if (append) {
+            binding.count++;
+        } else {
+            binding = {name, value, values.size() - 1, 1};
+        }
+        return;
+    }
+    bindings.push_back({name, value, values.size() - 1, 1});
+}
+
+void CommandArguments::joinValues() {
+    for (Binding& binding : bindings) {
+        if (binding.count < 2) {
+            continue;
+        }
+        std::pmr::string& text = joined.emplace_front();
+        for (size_t i = binding.first; i < binding.first + binding.count; i++) {
+            text.append(text.empty() ? "" : " ").append(values[i]);
+        }
+        binding.text = text;
+    }
+}
+
+CommandRegistry::Argument::Argument(std::string name, ArgumentType type, bool optional, Candidates candidates)
+    : name(std::move(name)), type(type), optional(optional), candidates(std::move(candidates)) {}
+
+CommandRegistry::CommandRegistry() {}
+
+void CommandRegistry::add(const std::string& path, const std::string& description, Handler handler, std::vector<Argument> arguments) {
+    Node* node = findOrCreate(path);
+    node->description = description;
+    node->handler = std::move(handler);
+    node->arguments = std::move(arguments);
+}
+
+void CommandRegistry::describe(const std::string& path, const std::string& description) {
+    findOrCreate(path)->description = description;
+}
+
+bool CommandRegistry::dispatch(const std::pmr::vector<std::string_view>& tokens, std::string_view line, bool complete, std::pmr::memory_resource* resource) const {
+    size_t consumed = 0;
+    const Node* node = walk(tokens, consumed);
+    bool remaining = consumed < tokens.size();
+    if (remaining && tokens[consumed] == "help" && acceptsHelp(*node)) {
+        printHelp(*node);
+        return true;
+    }
+    if (!node->handler) {
+        if (remaining) {
+            std::cerr << "Error: Unknown command '" << tokens[consumed] << "'. Try '" << getHelpCommand(node->path) << "' for a list of commands." << std::endl;
+        } else {
+            std::cerr << "Error: No arguments provided. Try '" << getHelpCommand(node->path) << "' for a list of commands." << std::endl;
+        }
+        return false;
+    }
+    CommandArguments arguments(resource);
+    arguments.line = line;
+    if (takesLine(*node)) {
+        std::string_view text = skipWords(line, consumed);
+        const Argument& argument = node->arguments.front();
+        if (!text.empty()) {
+            arguments.bind(argument.name, text, false);
+        } else if (!argument.optional) {
+            std::cerr << "Error: Missing " << argument.name << ". Usage: " << node->path << getUsage(*node) << std::endl;
+            return false;
+        }
+    } else if (!complete) {
+        std::cerr << "Error: Unterminated quote or trailing backslash." << std::endl;
+        return false;
+    } else if (!bindArguments(*node, tokens, consumed, arguments)) {
+        return false;
+    }
+    node->handler(arguments);
+    return true;
+}
+
+std::vector<std::string> CommandRegistry::getCompletions(const std::pmr::vector<std::string_view>& path, bool& completePaths) const {
+    size_t consumed = 0;
+    const Node* node = walk(path, consumed);
+    std::vector<std::string> candidates;
+    if (consumed == path.size()) {
+        for (const auto& child : node->children) {
+            candidates.push_back(child->name);
+        }
+        if (!node->children.empty() && node->index.find("help") == node->index.end()) {
+            candidates.push_back("help");
+        }
+    }
+    if (!node->handler) {
+        return candidates;
+    }
+    std::vector<const Argument*> positional;
+    bool hasOptions = false;
+    for (const Argument& argument : node->arguments) {
+        if (isOption(argument.name)) {
+            hasOptions = true;
+        } else {
+            positional.push_back(&argument);
+        }
+    }
+    const Argument* next = nullptr;
+    size_t position = 0;
+    for (size_t i = consumed; i < path.size(); i++) {
+        const Argument* option = findOption(*node, path[i]);
+        if (option != nullptr) {
+            if (i + 1 == path.size()) {
+                next = option;
+                break;
+            }
+            i++;
+        } else if (position < positional.size() && positional[position]->type != ArgumentType::Rest && positional[position]->type != ArgumentType::Line) {
+            position++;
+        }
+    }
+    if (next == nullptr) {
+        if (hasOptions) {
+            for (const Argument& argument : node->arguments) {
+                if (isOption(argument.name)) {
+                    candidates.push_back(argument.name);
+                }
+            }
+        }
+        if (position < positional.size()) {
+            next = positional[position];
+        }
+    }
+    if (next != nullptr) {
+        if (next->type == ArgumentType::Path) {
+            completePaths = true;
+        } else if (next->candidates) {
+            std::vector<std::string> values = next->candidates();
+            candidates.insert(candidates.end(), values.begin(), values.end());
+        }
+    }
+    return candidates;
+}
+
+bool CommandRegistry::isCommand(std::string_view name) const {
+    return root.index.find(std::string(name)) != root.index.end();
+}
+
+void CommandRegistry::printHelp(const std::pmr::vector<std::string_view>& path) const {
+    size_t consumed = 0;
+    const Node* node = walk(path, consumed);
+    if (consumed < path.size()) {
+        std::cerr << "Error: Unknown command '" << path[consumed] << "'. Try '" << getHelpCommand(node->path) << "' for a list of commands." << std::endl;
+        return;
+    }
+    printHelp(*node);
+}
+
+CommandRegistry::Node* CommandRegistry::findOrCreate(const std::string& path) {
+    Node* node = &root;
+    size_t start = 0;
+    while (start < path.size()) {
+        size_t end = path.find(' ', start);
+        if (end == std::string::npos) {
+            end = path.size();
+        }
+        std::string name = path.substr(start, end - start);
+        start = end + 1;
+        if (name.empty()) {
+            continue;
+        }
+        auto it = node->index.find(name);
+        if (it != node->index.end()) {
+            node = it->second;
+            continue;
+        }
+        auto child = std::make_unique<Node>();
+        child->name = name;
+        child->path = node->path.empty() ? name : node->path + " " + name;
+        Node* created = child.get();
+        node->children.push_back(std::move(child));
+        node->index[name] = created;
+        node = created;
+    }
+    return node;
+}
+
+const CommandRegistry::Node* CommandRegistry::walk(const std::pmr::vector<std::string_view>& tokens, size_t& consumed) const {
+    const Node* node = &root;
+    consumed = 0;
+    while (consumed < tokens.size()) {
+        auto it = node->index.find(std::string(tokens[consumed]));
+        if (it == node->index.end()) {
+            break;
+        }
+        node = it->second;
+        consumed++;
+    }
+    return node;
+}
+
+bool CommandRegistry::acceptsHelp(const Node& node) {
+    return !node.children.empty() || std::all_of(node.arguments.begin(), node.arguments.end(), [](const Argument& argument) {
+        return isOption(argument.name);
+    });
+}
+
+bool CommandRegistry::takesLine(const Node& node) {
+    return !node.arguments.empty() && node.arguments.front().type == ArgumentType::Line;
+}
+
+const CommandRegistry::Argument* CommandRegistry::findOption(const Node& node, std::string_view name) const {
+    if (!isOption(name)) {
+        return nullptr;
+    }
+    for (const Argument& argument : node.arguments) {
+        if (argument.name == name) {
+            return &argument;
+        }
+    }
+    return nullptr;
+}
+
+bool CommandRegistry::bindArguments(const Node& node, const std::pmr::vector<std::string_view>& tokens, size_t start, CommandArguments& arguments) const {
+    auto checkType = [](const Argument& argument, std::string_view value) {
+        if (argument.type == ArgumentType::Number && !isNumber(value)) {
+            std::cerr << "Error: Expected a number for " << argument.name << "." << std::endl;
+            return false;
+        }
+        return true;
+    };
+    auto nextPositional = [&node](size_t index) {
+        while (index < node.arguments.size() && isOption(node.arguments[index].name)) {
+            index++;
+        }
+        return index;
+    };
+    bool hasOptions = std::any_of(node.arguments.begin(), node.arguments.end(), [](const Argument& argument) {
+        return isOption(argument.name);
+    });
+    size_t position = nextPositional(0);
+    bool inRest = false;
+    for (size_t i = start; i < tokens.size(); i++) {
+        std::string_view token = tokens[i];
+        const Argument* option = inRest ? nullptr : findOption(node, token);
+        if (option != nullptr) {
+            if (i + 1 >= tokens.size()) {
+                std::cerr << "Error: Missing value for " << token << std::endl;
+                return false;
+            }
+            std::string_view value = tokens[++i];
+            if (!checkType(*option, value)) {
+                return false;
+            }
+            arguments.bind(option->name, value, false);
+            continue;
+        }
+        if (position >= node.arguments.size()) {
+            if (hasOptions && isOption(token)) {
+                std::cerr << "Error: Unknown option " << token << std::endl;
+            } else {
+                std::cerr << "Error: Unexpected argument '" << token << "'. Usage: " << node.path << getUsage(node) << std::endl;
+            }
+            return false;
+        }
+        const Argument& argument = node.arguments[position];
+        if (!checkType(argument, token)) {
+            return false;
+        }
+        if (argument.type == ArgumentType::Rest) {
+            arguments.bind(argument.name, token, inRest);
+            inRest = true;
+            continue;
+        }
+        arguments.bind(argument.name, token, false);
+        position = nextPositional(position + 1);
+    }
+    for (const Argument& argument : node.arguments) {
+        if (!isOption(argument.name) && !argument.optional && !arguments.has(argument.name)) {
+            std::cerr << "Error: Missing " << argument.name << ". Usage: " << node.path << getUsage(node) << std::endl;
+            return false;
+        }
+    }
+    arguments.joinValues();
+    return true;
+}
+
+void CommandRegistry::printHelp(const Node& node) const {
+    if (node.handler && !node.path.empty()) {
+        std::cout << "Usage: " << node.path << getUsage(node) << std::endl;
+        if (!node.description.empty()) {
+            std::cout << node.description << std::endl;
+        }
+    }
+    if (node.children.empty()) {
+        return;
+    }
+    std::vector<std::string> labels;
+    size_t width = 0;
+    for (const auto& child : node.children) {
+        std::string label = child->name + getUsage(*child) + (child->children.empty() ? "" : " ...");
+        width = std::max(width, label.length());
+        labels.push_back(label);
+    }
+    std::cout << "Commands:" << std::endl;
+    for (size_t i = 0; i < labels.size(); i++) {
+        std::cout << "  " << labels[i];
+        if (!node.children[i]->description.empty()) {
+            std::cout << std::string(width - labels[i].length() + 2, ' ') << node.children[i]->description;
+        }
+        std::cout << std::endl;
+    }
+}
+
+std::string CommandRegistry::getUsage(const Node& node) {
+    std::string usage;
+    for (const Argument& argument : node.arguments) {
+        if (isOption(argument.name)) {
+            std::string value = argument.type == ArgumentType::Number ? "N" : argument.type == ArgumentType::Path ? "PATH" : "TEXT";
+            usage += " [" + argument.name + " " + value + "]";
+            continue;
+        }
+        std::string name = argument.name + (argument.type == ArgumentType::Rest || argument.type == ArgumentType::Line ? "..." : "");
+        usage += argument.optional ? " [" + name + "]" : " " + name;
+    }
+    return usage;
+}
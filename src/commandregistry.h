@@ -0,0 +1,99 @@
+#ifndef COMMANDREGISTRY_H
+#define COMMANDREGISTRY_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <forward_list>
+#include <memory_resource>
+#include <memory>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+class CommandArguments {
+public:
+    explicit CommandArguments(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    bool has(std::string_view name) const;
+    std::string_view get(std::string_view name) const;
+    uint64_t getNumber(std::string_view name) const;
+    std::pmr::vector<std::string_view> getList(std::string_view name) const;
+    std::string_view getLine() const;
+
+private:
+    friend class CommandRegistry;
+
+    struct Binding {
+        std::string_view name;
+        std::string_view text;
+        size_t first = 0;
+        size_t count = 0;
+    };
+
+    const Binding* find(std::string_view name) const;
+    void bind(std::string_view name, std::string_view value, bool append);
+    void joinValues();
+
+    std::pmr::vector<std::string_view> values;
+    std::pmr::vector<Binding> bindings;
+    std::pmr::forward_list<std::pmr::string> joined;
+    std::string_view line;
+};
+
+class CommandRegistry {
+public:
+    enum class ArgumentType {
+        Text,
+        Number,
+        Path,
+        Rest,
+        Line
+    };
+
+    using Candidates = std::function<std::vector<std::string>()>;
+
+    struct Argument {
+        Argument(std::string name, ArgumentType type = ArgumentType::Text, bool optional = false, Candidates candidates = {});
+
+        std::string name;
+        ArgumentType type;
+        bool optional;
+        Candidates candidates;
+    };
+
+    using Handler = std::function<void(const CommandArguments&)>;
+
+    CommandRegistry();
+
+    void add(const std::string& path, const std::string& description, Handler handler, std::vector<Argument> arguments = {});
+    void describe(const std::string& path, const std::string& description);
+
+    bool dispatch(const std::pmr::vector<std::string_view>& tokens, std::string_view line, bool complete, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+    std::vector<std::string> getCompletions(const std::pmr::vector<std::string_view>& path, bool& completePaths) const;
+    bool isCommand(std::string_view name) const;
+    void printHelp(const std::pmr::vector<std::string_view>& path) const;
+
+private:
+    struct Node {
+        std::string name;
+        std::string path;
+        std::string description;
+        Handler handler;
+        std::vector<Argument> arguments;
+        std::vector<std::unique_ptr<Node>> children;
+        std::unordered_map<std::string, Node*> index;
+    };
+
+    Node* findOrCreate(const std::string& path);
+    const Node* walk(const std::pmr::vector<std::string_view>& tokens, size_t& consumed) const;
+    const Argument* findOption(const Node& node, std::string_view name) const;
+    bool bindArguments(const Node& node, const std::pmr::vector<std::string_view>& tokens, size_t start, CommandArguments& arguments) const;
+    void printHelp(const Node& node) const;
+    static bool acceptsHelp(const Node& node);
+    static bool takesLine(const Node& node);
+    static std::string getUsage(const Node& node);
+
+    Node root;
+};
+
+#endif // COMMANDREGISTRY_H
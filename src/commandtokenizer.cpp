@@ -0,0 +1,89 @@
+#include "commandtokenizer.h"
+
+static bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool isSpecial(char c) {
+    return c == '\'' || c == '"' || c == '\\';
+}
+
+static bool isEscapableInDoubleQuotes(char c) {
+    return c == '$' || c == '`' || c == '"' || c == '\\' || c == '\n';
+}
+
+CommandTokenizer::CommandTokenizer(std::pmr::memory_resource* resource) : tokens(resource), buffer(resource) {}
+
+const std::pmr::vector<std::string_view>& CommandTokenizer::tokenize(std::string_view line) {
+    tokens.clear();
+    buffer.clear();
+    complete = true;
+    size_t length = line.size();
+    size_t i = 0;
+    while (true) {
+        while (i < length && isSeparator(line[i])) {
+            i++;
+        }
+        if (i >= length) {
+            break;
+        }
+        size_t start = i;
+        while (i < length && !isSeparator(line[i]) && !isSpecial(line[i])) {
+            i++;
+        }
+        if (i >= length || isSeparator(line[i])) {
+            tokens.push_back(line.substr(start, i - start));
+            continue;
+        }
+        if (buffer.capacity() < length) {
+            buffer.reserve(length);
+        }
+        size_t tokenStart = buffer.size();
+        buffer.append(line.data() + start, i - start);
+        while (i < length && !isSeparator(line[i])) {
+            char c = line[i];
+            if (c == '\\') {
+                if (i + 1 < length) {
+                    buffer.push_back(line[i + 1]);
+                } else {
+                    complete = false;
+                }
+                i += 2;
+            } else if (c == '\'') {
+                size_t end = line.find('\'', i + 1);
+                if (end == std::string_view::npos) {
+                    complete = false;
+                    end = length;
+                }
+                buffer.append(line.data() + i + 1, end - i - 1);
+                i = end + 1;
+            } else if (c == '"') {
+                i++;
+                while (i < length && line[i] != '"') {
+                    if (line[i] == '\\' && i + 1 < length && isEscapableInDoubleQuotes(line[i + 1])) {
+                        i++;
+                    }
+                    buffer.push_back(line[i]);
+                    i++;
+                }
+                if (i >= length) {
+                    complete = false;
+                }
+                i++;
+            } else {
+                buffer.push_back(c);
+                i++;
+            }
+        }
+        tokens.push_back(std::string_view(buffer.data() + tokenStart, buffer.size() - tokenStart));
+    }
+    return tokens;
+}
+
+const std::pmr::vector<std::string_view>& CommandTokenizer::getTokens() const {
+    return tokens;
+}
+
+bool CommandTokenizer::isComplete() const {
+    return complete;
+}
@@ -0,0 +1,22 @@
+#ifndef COMMANDTOKENIZER_H
+#define COMMANDTOKENIZER_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory_resource>
+
+class CommandTokenizer {
+public:
+    explicit CommandTokenizer(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    const std::pmr::vector<std::string_view>& tokenize(std::string_view line);
+    const std::pmr::vector<std::string_view>& getTokens() const;
+    bool isComplete() const;
+
+private:
+    std::pmr::vector<std::string_view> tokens;
+    std::pmr::string buffer;
+    bool complete = true;
+};
+
+#endif // COMMANDTOKENIZER_H
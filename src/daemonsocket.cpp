@@ -0,0 +1,190 @@
+#include "daemonsocket.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static const uint32_t MAX_REQUEST_BYTES = 64 * 1024;
+
+static bool makeAddress(const std::filesystem::path& path, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.native().size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::strcpy(address.sun_path, path.c_str());
+    return true;
+}
+
+static bool readFully(int socket, char* data, size_t length) {
+    while (length > 0) {
+        ssize_t count = ::read(socket, data, length);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        data += count;
+        length -= static_cast<size_t>(count);
+    }
+    return true;
+}
+
+static void closePassedDescriptors(msghdr& message) {
+    for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS || header->cmsg_len < CMSG_LEN(0)) {
+            continue;
+        }
+        size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (size_t i = 0; i < count; i++) {
+            int descriptor;
+            std::memcpy(&descriptor, CMSG_DATA(header) + i * sizeof(int), sizeof(int));
+            ::close(descriptor);
+        }
+    }
+}
+
+static bool writeFully(int socket, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t count = ::send(socket, data, length, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        data += count;
+        length -= static_cast<size_t>(count);
+    }
+    return true;
+}
+
+int DaemonSocket::listenAt(const std::filesystem::path& path, std::string& error) {
+    sockaddr_un address;
+    if (!makeAddress(path, address)) {
+        error = "The socket path " + path.string() + " is too long.";
+        return -1;
+    }
+    int existing = connectTo(path);
+    if (existing >= 0) {
+        ::close(existing);
+        error = "A daemon is already listening on " + path.string() + ".";
+        return -1;
+    }
+    ::unlink(path.c_str());
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error = std::strerror(errno);
+        return -1;
+    }
+    mode_t previous = ::umask(0077);
+    bool bound = ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    ::umask(previous);
+    if (!bound || ::listen(fd, 16) != 0) {
+        error = std::strerror(errno);
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int DaemonSocket::connectTo(const std::filesystem::path& path) {
+    sockaddr_un address;
+    if (!makeAddress(path, address)) {
+        return -1;
+    }
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool DaemonSocket::sendRequest(int socket, const std::vector<std::string>& arguments, const int descriptors[PASSED_DESCRIPTORS]) {
+    std::string payload;
+    for (const std::string& argument : arguments) {
+        payload.append(argument).push_back('\0');
+    }
+    if (payload.size() > MAX_REQUEST_BYTES) {
+        return false;
+    }
+    uint32_t length = static_cast<uint32_t>(payload.size());
+    iovec vector = {&length, sizeof(length)};
+    char control[CMSG_SPACE(sizeof(int) * PASSED_DESCRIPTORS)];
+    std::memset(control, 0, sizeof(control));
+    msghdr message = {};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(int) * PASSED_DESCRIPTORS);
+    std::memcpy(CMSG_DATA(header), descriptors, sizeof(int) * PASSED_DESCRIPTORS);
+    ssize_t sent;
+    do {
+        sent = ::sendmsg(socket, &message, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    return sent == sizeof(length) && writeFully(socket, payload.data(), payload.size());
+}
+
+bool DaemonSocket::receiveRequest(int socket, std::vector<std::string>& arguments, int descriptors[PASSED_DESCRIPTORS]) {
+    uint32_t length = 0;
+    iovec vector = {&length, sizeof(length)};
+    char control[CMSG_SPACE(sizeof(int) * PASSED_DESCRIPTORS)];
+    std::memset(control, 0, sizeof(control));
+    msghdr message = {};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    ssize_t received;
+    do {
+        received = ::recvmsg(socket, &message, MSG_CMSG_CLOEXEC);
+    } while (received < 0 && errno == EINTR);
+    if (received < 0) {
+        return false;
+    }
+    cmsghdr* header = CMSG_FIRSTHDR(&message);
+    if (received != sizeof(length) || (message.msg_flags & MSG_CTRUNC) != 0 || header == nullptr ||
+        header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS ||
+        header->cmsg_len != CMSG_LEN(sizeof(int) * PASSED_DESCRIPTORS)) {
+        closePassedDescriptors(message);
+        return false;
+    }
+    std::memcpy(descriptors, CMSG_DATA(header), sizeof(int) * PASSED_DESCRIPTORS);
+    std::string payload;
+    if (length <= MAX_REQUEST_BYTES) {
+        payload.resize(length);
+    }
+    if (payload.size() != length || !readFully(socket, payload.data(), payload.size())) {
+        for (int i = 0; i < PASSED_DESCRIPTORS; i++) {
+            ::close(descriptors[i]);
+        }
+        return false;
+    }
+    arguments.clear();
+    size_t start = 0;
+    while (start < payload.size()) {
+        size_t end = payload.find('\0', start);
+        arguments.push_back(payload.substr(start, end - start));
+        start = end + 1;
+    }
+    return true;
+}
+
+bool DaemonSocket::sendValue(int socket, int32_t value) {
+    return writeFully(socket, reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool DaemonSocket::receiveValue(int socket, int32_t& value) {
+    return readFully(socket, reinterpret_cast<char*>(&value), sizeof(value));
+}
@@ -0,0 +1,21 @@
+#ifndef DAEMONSOCKET_H
+#define DAEMONSOCKET_H
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+class DaemonSocket {
+public:
+    static const int PASSED_DESCRIPTORS = 3;
+
+    static int listenAt(const std::filesystem::path& path, std::string& error);
+    static int connectTo(const std::filesystem::path& path);
+
+    static bool sendRequest(int socket, const std::vector<std::string>& arguments, const int descriptors[PASSED_DESCRIPTORS]);
+    static bool receiveRequest(int socket, std::vector<std::string>& arguments, int descriptors[PASSED_DESCRIPTORS]);
+    static bool sendValue(int socket, int32_t value);
+    static bool receiveValue(int socket, int32_t& value);
+};
+
+#endif // DAEMONSOCKET_H
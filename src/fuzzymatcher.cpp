@@ -0,0 +1,281 @@
+#include "fuzzymatcher.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FUZZYMATCHER_X86 1
+#endif
+
+static size_t findByteScalar(const char* data, size_t from, size_t length, char lower, char upper) {
+    for (size_t i = from; i < length; i++) {
+        if (data[i] == lower || data[i] == upper) {
+            return i;
+        }
+    }
+    return std::string::npos;
+}
+
+#ifdef FUZZYMATCHER_X86
+static size_t findByteSSE2(const char* data, size_t from, size_t length, char lower, char upper) {
+    const __m128i lowerVector = _mm_set1_epi8(lower);
+    const __m128i upperVector = _mm_set1_epi8(upper);
+    size_t i = from;
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, lowerVector), _mm_cmpeq_epi8(chunk, upperVector));
+        int mask = _mm_movemask_epi8(hits);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return findByteScalar(data, i, length, lower, upper);
+}
+
+__attribute__((target("avx2")))
+static size_t findByteAVX2(const char* data, size_t from, size_t length, char lower, char upper) {
+    const __m256i lowerVector = _mm256_set1_epi8(lower);
+    const __m256i upperVector = _mm256_set1_epi8(upper);
+    size_t i = from;
+    for (; i + 32 <= length; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, lowerVector), _mm256_cmpeq_epi8(chunk, upperVector));
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(hits));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return findByteSSE2(data, i, length, lower, upper);
+}
+
+static bool buildMasksSSE2(const char* block, const char* lower, const char* upper, size_t queryLength, uint64_t* masks) {
+    __m128i chunks[4];
+    for (int c = 0; c < 4; c++) {
+        chunks[c] = _mm_load_si128(reinterpret_cast<const __m128i*>(block + c * 16));
+    }
+    for (size_t i = 0; i < queryLength; i++) {
+        const __m128i lowerVector = _mm_set1_epi8(lower[i]);
+        const __m128i upperVector = _mm_set1_epi8(upper[i]);
+        uint64_t mask = 0;
+        for (int c = 0; c < 4; c++) {
+            __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunks[c], lowerVector), _mm_cmpeq_epi8(chunks[c], upperVector));
+            mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(hits))) << (c * 16);
+        }
+        if (mask == 0) {
+            return false;
+        }
+        masks[i] = mask;
+    }
+    return true;
+}
+
+__attribute__((target("avx2")))
+static bool buildMasksAVX2(const char* block, const char* lower, const char* upper, size_t queryLength, uint64_t* masks) {
+    const __m256i low = _mm256_load_si256(reinterpret_cast<const __m256i*>(block));
+    const __m256i high = _mm256_load_si256(reinterpret_cast<const __m256i*>(block + 32));
+    for (size_t i = 0; i < queryLength; i++) {
+        const __m256i lowerVector = _mm256_set1_epi8(lower[i]);
+        const __m256i upperVector = _mm256_set1_epi8(upper[i]);
+        __m256i lowHits = _mm256_or_si256(_mm256_cmpeq_epi8(low, lowerVector), _mm256_cmpeq_epi8(low, upperVector));
+        __m256i highHits = _mm256_or_si256(_mm256_cmpeq_epi8(high, lowerVector), _mm256_cmpeq_epi8(high, upperVector));
+        uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(lowHits)) |
+            (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(highHits))) << 32);
+        if (mask == 0) {
+            return false;
+        }
+        masks[i] = mask;
+    }
+    return true;
+}
+#endif
+
+FuzzyMatcher::FuzzyMatcher() : FuzzyMatcher(detectKernel()) {}
+
+FuzzyMatcher::FuzzyMatcher(Kernel kernel) : kernel(kernel), findFunction(findByteScalar), maskFunction(nullptr) {
+#ifdef FUZZYMATCHER_X86
+    if (kernel == Kernel::AVX2 && detectKernel() == Kernel::AVX2) {
+        findFunction = findByteAVX2;
+        maskFunction = buildMasksAVX2;
+    } else if (kernel != Kernel::Scalar) {
+        this->kernel = Kernel::SSE2;
+        findFunction = findByteSSE2;
+        maskFunction = buildMasksSSE2;
+    }
+#else
+    this->kernel = Kernel::Scalar;
+#endif
+}
+
+void FuzzyMatcher::setQuery(const std::string& query) {
+    bool caseSensitive = std::any_of(query.begin(), query.end(), [](unsigned char c) {
+        return std::isupper(c);
+    });
+    queryLower = query;
+    queryUpper = query;
+    if (!caseSensitive) {
+        for (char& c : queryUpper) {
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+    }
+}
+
+bool FuzzyMatcher::score(const std::string& candidate, int& result) const {
+    return score(candidate.data(), candidate.size(), result);
+}
+
+bool FuzzyMatcher::score(const char* candidate, size_t length, int& result) const {
+    result = 0;
+    if (queryLower.empty()) {
+        return true;
+    }
+    if (length < queryLower.size()) {
+        return false;
+    }
+    if (maskFunction != nullptr && length <= MASK_BLOCK_SIZE && queryLower.size() <= MASK_BLOCK_SIZE) {
+        alignas(32) char block[MASK_BLOCK_SIZE] = {};
+        std::memcpy(block, candidate, length);
+        uint64_t masks[MASK_BLOCK_SIZE];
+        if (!maskFunction(block, queryLower.data(), queryUpper.data(), queryLower.size(), masks)) {
+            return false;
+        }
+        return scoreFromMasks(candidate, masks, result);
+    }
+    size_t position = 0;
+    for (size_t i = 0; i < queryLower.size(); i++) {
+        size_t found = findFunction(candidate, position, length, queryLower[i], queryUpper[i]);
+        if (found == std::string::npos) {
+            return false;
+        }
+        position = found + 1;
+    }
+    size_t end = position - 1;
+    size_t start = end;
+    size_t queryIndex = queryLower.size() - 1;
+    for (size_t p = end + 1; p-- > 0;) {
+        if (matchesAt(candidate[p], queryIndex)) {
+            if (queryIndex == 0) {
+                start = p;
+                break;
+            }
+            queryIndex--;
+        }
+    }
+    size_t previous = start;
+    queryIndex = 0;
+    for (size_t p = start; p <= end && queryIndex < queryLower.size(); p++) {
+        if (!matchesAt(candidate[p], queryIndex)) {
+            continue;
+        }
+        result += scoreMatchAt(candidate, p, previous, queryIndex);
+        previous = p;
+        queryIndex++;
+    }
+    return true;
+}
+
+bool FuzzyMatcher::scoreFromMasks(const char* candidate, const uint64_t* masks, int& result) const {
+    size_t queryLength = queryLower.size();
+    int position = -1;
+    for (size_t i = 0; i < queryLength; i++) {
+        uint64_t available = position >= 63 ? 0 : masks[i] & (~0ULL << (position + 1));
+        if (available == 0) {
+            return false;
+        }
+        position = __builtin_ctzll(available);
+    }
+    for (size_t i = queryLength - 1; i-- > 0;) {
+        uint64_t below = masks[i] & ((1ULL << position) - 1);
+        position = 63 - __builtin_clzll(below);
+    }
+    size_t previous = position;
+    for (size_t i = 0; i < queryLength; i++) {
+        size_t p = i == 0 ? previous : __builtin_ctzll(masks[i] & (~0ULL << (previous + 1)));
+        result += scoreMatchAt(candidate, p, previous, i);
+        previous = p;
+    }
+    return true;
+}
+
+std::vector<FuzzyMatch> FuzzyMatcher::rank(const std::vector<std::string>& candidates, size_t limit) const {
+    auto better = [](const FuzzyMatch& a, const FuzzyMatch& b) {
+        return a.score != b.score ? a.score > b.score : a.index < b.index;
+    };
+    std::vector<FuzzyMatch> matches;
+    if (limit == 0) {
+        return matches;
+    }
+    matches.reserve(limit + 1);
+    int result;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (!score(candidates[i].data(), candidates[i].size(), result)) {
+            continue;
+        }
+        if (matches.size() == limit && result <= matches.front().score) {
+            continue;
+        }
+        matches.push_back({static_cast<uint32_t>(i), result});
+        std::push_heap(matches.begin(), matches.end(), better);
+        if (matches.size() > limit) {
+            std::pop_heap(matches.begin(), matches.end(), better);
+            matches.pop_back();
+        }
+    }
+    std::sort_heap(matches.begin(), matches.end(), better);
+    return matches;
+}
+
+FuzzyMatcher::Kernel FuzzyMatcher::getKernel() const {
+    return kernel;
+}
+
+FuzzyMatcher::Kernel FuzzyMatcher::detectKernel() {
+#ifdef FUZZYMATCHER_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return Kernel::AVX2;
+    }
+    return Kernel::SSE2;
+#else
+    return Kernel::Scalar;
+#endif
+}
+
+std::string FuzzyMatcher::getKernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::AVX2:
+            return "avx2";
+        case Kernel::SSE2:
+            return "sse2";
+        default:
+            return "scalar";
+    }
+}
+
+bool FuzzyMatcher::matchesAt(char c, size_t queryIndex) const {
+    return c == queryLower[queryIndex] || c == queryUpper[queryIndex];
+}
+
+int FuzzyMatcher::scoreMatchAt(const char* candidate, size_t position, size_t previous, size_t queryIndex) const {
+    int bonus = bonusAt(candidate, position);
+    if (queryIndex == 0) {
+        return SCORE_MATCH + bonus * BONUS_FIRST_CHAR_MULTIPLIER;
+    }
+    if (position == previous + 1) {
+        return SCORE_MATCH + std::max(bonus, BONUS_CONSECUTIVE);
+    }
+    return SCORE_MATCH + bonus + SCORE_GAP_START + SCORE_GAP_EXTENSION * static_cast<int>(position - previous - 2);
+}
+
+int FuzzyMatcher::bonusAt(const char* candidate, size_t position) const {
+    if (position == 0) {
+        return BONUS_BOUNDARY;
+    }
+    char previous = candidate[position - 1];
+    if (previous == '/' || previous == ' ' || previous == '-' || previous == '_' || previous == '.' || previous == ':') {
+        return BONUS_BOUNDARY;
+    }
+    if (std::islower(static_cast<unsigned char>(previous)) && std::isupper(static_cast<unsigned char>(candidate[position]))) {
+        return BONUS_CAMEL_CASE;
+    }
+    return 0;
+}
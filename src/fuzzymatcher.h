@@ -0,0 +1,54 @@
+#ifndef FUZZYMATCHER_H
+#define FUZZYMATCHER_H
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+struct FuzzyMatch {
+    uint32_t index;
+    int score;
+};
+
+class FuzzyMatcher {
+public:
+    enum class Kernel { Scalar, SSE2, AVX2 };
+
+    FuzzyMatcher();
+    explicit FuzzyMatcher(Kernel kernel);
+
+    void setQuery(const std::string& query);
+    bool score(const char* candidate, size_t length, int& result) const;
+    bool score(const std::string& candidate, int& result) const;
+    std::vector<FuzzyMatch> rank(const std::vector<std::string>& candidates, size_t limit) const;
+
+    Kernel getKernel() const;
+    static Kernel detectKernel();
+    static std::string getKernelName(Kernel kernel);
+
+private:
+    typedef size_t (*FindFunction)(const char* data, size_t from, size_t length, char lower, char upper);
+    typedef bool (*MaskFunction)(const char* block, const char* lower, const char* upper, size_t queryLength, uint64_t* masks);
+
+    bool scoreFromMasks(const char* candidate, const uint64_t* masks, int& result) const;
+    bool matchesAt(char c, size_t queryIndex) const;
+    int scoreMatchAt(const char* candidate, size_t position, size_t previous, size_t queryIndex) const;
+    int bonusAt(const char* candidate, size_t position) const;
+
+    Kernel kernel;
+    FindFunction findFunction;
+    MaskFunction maskFunction;
+    std::string queryLower;
+    std::string queryUpper;
+
+    static constexpr size_t MASK_BLOCK_SIZE = 64;
+    static constexpr int SCORE_MATCH = 16;
+    static constexpr int SCORE_GAP_START = -3;
+    static constexpr int SCORE_GAP_EXTENSION = -1;
+    static constexpr int BONUS_BOUNDARY = 8;
+    static constexpr int BONUS_CAMEL_CASE = 7;
+    static constexpr int BONUS_CONSECUTIVE = 4;
+    static constexpr int BONUS_FIRST_CHAR_MULTIPLIER = 2;
+};
+
+#endif // FUZZYMATCHER_H
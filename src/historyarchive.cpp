@@ -0,0 +1,283 @@
+#include "historyarchive.h"
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <zlib.h>
+
+static const char* INDEX_FILE = "segments.idx";
+static const char* LOCK_FILE = "segments.lock";
+static const size_t CHUNK_SIZE = 65536;
+
+HistoryArchive::HistoryArchive() {}
+
+bool HistoryArchive::open(const std::filesystem::path& directory) {
+    this->directory = directory;
+    segments.clear();
+    std::ifstream file(directory / INDEX_FILE);
+    if (!file.is_open()) {
+        return std::filesystem::is_directory(directory);
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        Segment segment;
+        long long first;
+        long long last;
+        if (fields >> segment.kind >> segment.name >> first >> last >> segment.entries >> segment.rawBytes) {
+            segment.firstTimestamp = static_cast<time_t>(first);
+            segment.lastTimestamp = static_cast<time_t>(last);
+            segments.push_back(segment);
+        }
+    }
+    return true;
+}
+
+std::vector<HistoryArchive::Segment> HistoryArchive::getSegments(const std::string& kind) const {
+    std::vector<Segment> matching;
+    for (const Segment& segment : segments) {
+        if (segment.kind == kind) {
+            matching.push_back(segment);
+        }
+    }
+    return matching;
+}
+
+uint64_t HistoryArchive::getSegmentSize(const Segment& segment) const {
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(directory / segment.name, ec);
+    return ec ? 0 : size;
+}
+
+bool HistoryArchive::writeSegment(const std::string& kind, const std::string& data, time_t firstTimestamp, time_t lastTimestamp, size_t entries, Segment& segment) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    std::random_device device;
+    char suffix[9];
+    snprintf(suffix, sizeof(suffix), "%08x", device());
+    segment.kind = kind;
+    segment.name = kind + "-" + std::to_string(firstTimestamp) + "-" + std::to_string(lastTimestamp) + "-" + suffix + ".dtz";
+    segment.firstTimestamp = firstTimestamp;
+    segment.lastTimestamp = lastTimestamp;
+    segment.entries = entries;
+    segment.rawBytes = data.size();
+
+    z_stream stream = {};
+    if (deflateInit(&stream, Z_BEST_COMPRESSION) != Z_OK) {
+        return false;
+    }
+    std::ofstream file(directory / segment.name, std::ios::binary | std::ios::trunc);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    char buffer[CHUNK_SIZE];
+    int status;
+    do {
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+        status = deflate(&stream, Z_FINISH);
+        file.write(buffer, sizeof(buffer) - stream.avail_out);
+    } while (status == Z_OK);
+    deflateEnd(&stream);
+    file.close();
+    if (status != Z_STREAM_END || !file) {
+        discardSegment(segment);
+        return false;
+    }
+    return true;
+}
+
+bool HistoryArchive::commitSegment(const Segment& segment) {
+    int lock = lockIndex();
+    if (lock < 0) {
+        return false;
+    }
+    open(directory);
+    segments.push_back(segment);
+    bool saved = saveIndex();
+    if (!saved) {
+        segments.pop_back();
+    }
+    unlockIndex(lock);
+    return saved;
+}
+
+bool HistoryArchive::removeSegment(const Segment& segment) {
+    int lock = lockIndex();
+    if (lock < 0) {
+        return false;
+    }
+    open(directory);
+    std::vector<Segment> kept;
+    for (const Segment& existing : segments) {
+        if (existing.name != segment.name) {
+            kept.push_back(existing);
+        }
+    }
+    segments = kept;
+    bool saved = saveIndex();
+    unlockIndex(lock);
+    return saved;
+}
+
+void HistoryArchive::discardSegment(const Segment& segment) {
+    std::error_code ec;
+    std::filesystem::remove(directory / segment.name, ec);
+}
+
+bool HistoryArchive::removeSegments(const std::string& kind) {
+    int lock = lockIndex();
+    if (lock < 0) {
+        return false;
+    }
+    open(directory);
+    std::vector<Segment> kept;
+    std::vector<Segment> removed;
+    for (const Segment& segment : segments) {
+        (segment.kind == kind ? removed : kept).push_back(segment);
+    }
+    segments = kept;
+    bool saved = saveIndex();
+    if (saved) {
+        for (const Segment& segment : removed) {
+            discardSegment(segment);
+        }
+    }
+    unlockIndex(lock);
+    return saved;
+}
+
+bool HistoryArchive::readSegment(const Segment& segment, const std::function<bool(const char*, size_t)>& consumer) const {
+    std::ifstream file(directory / segment.name, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    z_stream stream = {};
+    if (inflateInit(&stream) != Z_OK) {
+        return false;
+    }
+    char input[CHUNK_SIZE];
+    char output[CHUNK_SIZE];
+    int status = Z_OK;
+    while (status != Z_STREAM_END) {
+        file.read(input, sizeof(input));
+        if (file.gcount() <= 0) {
+            break;
+        }
+        stream.next_in = reinterpret_cast<Bytef*>(input);
+        stream.avail_in = static_cast<uInt>(file.gcount());
+        do {
+            stream.next_out = reinterpret_cast<Bytef*>(output);
+            stream.avail_out = sizeof(output);
+            status = inflate(&stream, Z_NO_FLUSH);
+            if (status != Z_OK && status != Z_STREAM_END) {
+                inflateEnd(&stream);
+                return false;
+            }
+            size_t produced = sizeof(output) - stream.avail_out;
+            if (produced > 0 && !consumer(output, produced)) {
+                inflateEnd(&stream);
+                return true;
+            }
+        } while (stream.avail_out == 0 && status != Z_STREAM_END);
+    }
+    inflateEnd(&stream);
+    return status == Z_STREAM_END;
+}
+
+bool HistoryArchive::forEachRecord(const Segment& segment, const std::function<bool(const HistoryRecord&)>& visitor) const {
+    std::string pending;
+    HistoryRecord record;
+    bool stopped = false;
+    bool complete = readSegment(segment, [&](const char* data, size_t length) {
+        pending.append(data, length);
+        size_t offset = 0;
+        size_t next = 0;
+        while (MappedHistory::decodeRecord(pending.data(), pending.size(), next, record)) {
+            offset = next;
+            if (!visitor(record)) {
+                stopped = true;
+                return false;
+            }
+        }
+        pending.erase(0, offset);
+        return true;
+    });
+    return complete && (stopped || pending.empty());
+}
+
+bool HistoryArchive::forEachFile(const Segment& segment, const std::function<bool(const std::string&, const std::string&)>& visitor) const {
+    std::string pending;
+    bool stopped = false;
+    bool complete = readSegment(segment, [&](const char* data, size_t length) {
+        pending.append(data, length);
+        size_t offset = 0;
+        while (true) {
+            size_t lineEnd = pending.find('\n', offset);
+            if (lineEnd == std::string::npos) {
+                break;
+            }
+            size_t separator = pending.rfind(' ', lineEnd);
+            if (separator == std::string::npos || separator < offset) {
+                return false;
+            }
+            size_t size = std::strtoull(pending.c_str() + separator + 1, nullptr, 10);
+            if (pending.size() - lineEnd - 1 < size) {
+                break;
+            }
+            if (!visitor(pending.substr(offset, separator - offset), pending.substr(lineEnd + 1, size))) {
+                stopped = true;
+                return false;
+            }
+            offset = lineEnd + 1 + size;
+        }
+        pending.erase(0, offset);
+        return true;
+    });
+    return complete && (stopped || pending.empty());
+}
+
+std::string HistoryArchive::encodeFile(const std::string& name, const std::string& content) {
+    return name + " " + std::to_string(content.size()) + "\n" + content;
+}
+
+int HistoryArchive::lockIndex() const {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    int fd = ::open((directory / LOCK_FILE).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+    while (::flock(fd, LOCK_EX) != 0) {
+        if (errno != EINTR) {
+            ::close(fd);
+            return -1;
+        }
+    }
+    return fd;
+}
+
+void HistoryArchive::unlockIndex(int fd) {
+    ::flock(fd, LOCK_UN);
+    ::close(fd);
+}
+
+bool HistoryArchive::saveIndex() const {
+    std::filesystem::path temporary = directory / (std::string(INDEX_FILE) + ".tmp");
+    std::ofstream file(temporary, std::ios::trunc);
+    for (const Segment& segment : segments) {
+        file << segment.kind << " " << segment.name << " " << static_cast<long long>(segment.firstTimestamp) << " "
+             << static_cast<long long>(segment.lastTimestamp) << " " << segment.entries << " " << segment.rawBytes << "\n";
+    }
+    file.close();
+    std::error_code ec;
+    if (!file) {
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    std::filesystem::rename(temporary, directory / INDEX_FILE, ec);
+    return !ec;
+}
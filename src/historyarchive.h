@@ -0,0 +1,49 @@
+#ifndef HISTORYARCHIVE_H
+#define HISTORYARCHIVE_H
+#include <string>
+#include <vector>
+#include <ctime>
+#include <cstdint>
+#include <functional>
+#include <filesystem>
+#include "mappedhistory.h"
+
+class HistoryArchive {
+public:
+    struct Segment {
+        std::string kind;
+        std::string name;
+        time_t firstTimestamp = 0;
+        time_t lastTimestamp = 0;
+        size_t entries = 0;
+        uint64_t rawBytes = 0;
+    };
+
+    HistoryArchive();
+
+    bool open(const std::filesystem::path& directory);
+    std::vector<Segment> getSegments(const std::string& kind) const;
+    uint64_t getSegmentSize(const Segment& segment) const;
+
+    bool writeSegment(const std::string& kind, const std::string& data, time_t firstTimestamp, time_t lastTimestamp, size_t entries, Segment& segment);
+    bool commitSegment(const Segment& segment);
+    bool removeSegment(const Segment& segment);
+    void discardSegment(const Segment& segment);
+    bool removeSegments(const std::string& kind);
+
+    bool readSegment(const Segment& segment, const std::function<bool(const char*, size_t)>& consumer) const;
+    bool forEachRecord(const Segment& segment, const std::function<bool(const HistoryRecord&)>& visitor) const;
+    bool forEachFile(const Segment& segment, const std::function<bool(const std::string&, const std::string&)>& visitor) const;
+
+    static std::string encodeFile(const std::string& name, const std::string& content);
+
+private:
+    int lockIndex() const;
+    static void unlockIndex(int fd);
+    bool saveIndex() const;
+
+    std::filesystem::path directory;
+    std::vector<Segment> segments;
+};
+
+#endif // HISTORYARCHIVE_H
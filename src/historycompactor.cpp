@@ -0,0 +1,259 @@
+#include "historycompactor.h"
+#include "historyarchive.h"
+#include <algorithm>
+#include <cerrno>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static int64_t steadyNow() {
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+static bool writeFully(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = ::write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+static bool copyTail(int source, int destination, uint64_t from, uint64_t to) {
+    char buffer[65536];
+    while (from < to) {
+        ssize_t count = ::pread(source, buffer, std::min<uint64_t>(sizeof(buffer), to - from), static_cast<off_t>(from));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0 || !writeFully(destination, buffer, static_cast<size_t>(count))) {
+            return false;
+        }
+        from += static_cast<uint64_t>(count);
+    }
+    return true;
+}
+
+HistoryCompactor::HistoryCompactor() : lastActivity(steadyNow()), maxEntries(10000), maxAgeDays(0) {}
+
+HistoryCompactor::~HistoryCompactor() {
+    stop();
+}
+
+void HistoryCompactor::start(const std::filesystem::path& file, const std::filesystem::path& archiveDirectory) {
+    stop();
+    path = file;
+    archivePath = archiveDirectory;
+    stopping = false;
+    checked = false;
+    worker = std::thread(&HistoryCompactor::run, this);
+}
+
+void HistoryCompactor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void HistoryCompactor::notifyActivity() {
+    lastActivity.store(steadyNow(), std::memory_order_relaxed);
+}
+
+void HistoryCompactor::setPeriodicTask(std::function<void()> task) {
+    periodicTask = std::move(task);
+}
+
+bool HistoryCompactor::compactNow(Result& result) {
+    std::lock_guard<std::mutex> guard(compactionMutex);
+    bool compacted = compact(path, archivePath, maxEntries, maxAgeDays, result);
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(path, ec);
+    std::lock_guard<std::mutex> lock(mutex);
+    checked = true;
+    compactedSize = ec ? 0 : size;
+    return compacted;
+}
+
+void HistoryCompactor::setLimits(size_t maxEntries, uint32_t maxAgeDays) {
+    this->maxEntries = maxEntries;
+    this->maxAgeDays = maxAgeDays;
+    std::lock_guard<std::mutex> lock(mutex);
+    checked = false;
+}
+
+size_t HistoryCompactor::getMaxEntries() const {
+    return maxEntries;
+}
+
+uint32_t HistoryCompactor::getMaxAgeDays() const {
+    return maxAgeDays;
+}
+
+bool HistoryCompactor::compact(const std::filesystem::path& file, const std::filesystem::path& archiveDirectory, size_t maxEntries, uint32_t maxAgeDays, Result& result) {
+    result = Result();
+    MappedHistory history;
+    if (!history.open(file)) {
+        return false;
+    }
+    uint64_t snapshotLength = history.getIndexedLength();
+    result.recordsBefore = history.size();
+    result.bytesBefore = snapshotLength;
+    result.bytesAfter = snapshotLength;
+
+    std::vector<HistoryRecord> records;
+    std::unordered_map<std::string, size_t> positions;
+    HistoryRecord record;
+    for (size_t i = 0; i < history.size(); i++) {
+        if (!history.getRecord(i, record)) {
+            continue;
+        }
+        auto [it, inserted] = positions.emplace(record.directory + '\0' + record.command, records.size());
+        if (inserted) {
+            records.push_back(record);
+            continue;
+        }
+        HistoryRecord& existing = records[it->second];
+        uint32_t count = existing.count + record.count;
+        time_t lastUsed = std::max(existing.timestamp, record.timestamp);
+        existing = record;
+        existing.count = count;
+        existing.timestamp = lastUsed;
+    }
+    std::stable_sort(records.begin(), records.end(), [](const HistoryRecord& a, const HistoryRecord& b) {
+        return a.timestamp < b.timestamp;
+    });
+    auto kept = records.begin();
+    if (maxAgeDays > 0) {
+        time_t cutoff = time(nullptr) - static_cast<time_t>(maxAgeDays) * 86400;
+        kept = std::partition_point(records.begin(), records.end(), [cutoff](const HistoryRecord& entry) {
+            return entry.timestamp < cutoff;
+        });
+    }
+    if (maxEntries > 0 && static_cast<size_t>(records.end() - kept) > maxEntries) {
+        kept = records.end() - maxEntries;
+    }
+    HistoryArchive archive;
+    HistoryArchive::Segment segment;
+    bool archiving = kept != records.begin() && !archiveDirectory.empty();
+    if (archiving) {
+        std::string evicted;
+        for (auto it = records.begin(); it != kept; ++it) {
+            evicted += MappedHistory::encodeRecord(*it);
+        }
+        archive.open(archiveDirectory);
+        if (!archive.writeSegment("history", evicted, records.front().timestamp, (kept - 1)->timestamp, kept - records.begin(), segment)) {
+            return false;
+        }
+    }
+    records.erase(records.begin(), kept);
+    result.recordsAfter = records.size();
+    if (records.size() == result.recordsBefore) {
+        return true;
+    }
+
+    std::string content = MappedHistory::createHeader();
+    for (const HistoryRecord& entry : records) {
+        content += MappedHistory::encodeRecord(entry);
+    }
+    std::filesystem::path temporary = file;
+    temporary += ".compact";
+    int output = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (output < 0) {
+        if (archiving) {
+            archive.discardSegment(segment);
+        }
+        return false;
+    }
+    int input = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    bool success = input >= 0 && writeFully(output, content.data(), content.size());
+    if (success) {
+        while (::flock(input, LOCK_EX) != 0 && errno == EINTR) {}
+        struct stat locked;
+        struct stat current;
+        uint64_t lockedId = 0;
+        success = ::fstat(input, &locked) == 0 && ::stat(file.c_str(), &current) == 0 &&
+            locked.st_dev == current.st_dev && locked.st_ino == current.st_ino &&
+            ::pread(input, &lockedId, sizeof(lockedId), 8) == sizeof(lockedId) && lockedId == history.getFileId() &&
+            static_cast<uint64_t>(locked.st_size) >= snapshotLength &&
+            copyTail(input, output, snapshotLength, static_cast<uint64_t>(locked.st_size)) &&
+            ::fdatasync(output) == 0;
+        bool committed = false;
+        if (success && archiving) {
+            success = committed = archive.commitSegment(segment);
+        }
+        if (success) {
+            result.bytesAfter = content.size() + (static_cast<uint64_t>(locked.st_size) - snapshotLength);
+            success = ::rename(temporary.c_str(), file.c_str()) == 0;
+        }
+        if (committed && !success && !archive.removeSegment(segment)) {
+            archiving = false;
+        }
+        if (success && archiving) {
+            result.archived = segment.entries;
+        }
+        ::flock(input, LOCK_UN);
+    }
+    if (input >= 0) {
+        ::close(input);
+    }
+    ::close(output);
+    std::error_code ec;
+    if (!success) {
+        std::filesystem::remove(temporary, ec);
+        if (archiving) {
+            archive.discardSegment(segment);
+        }
+        result.bytesAfter = result.bytesBefore;
+        return false;
+    }
+    std::filesystem::remove(MappedHistory::getIndexPath(file), ec);
+    result.rewritten = true;
+    return true;
+}
+
+void HistoryCompactor::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        wake.wait_for(lock, POLL_INTERVAL);
+        if (stopping) {
+            continue;
+        }
+        bool due = isDue();
+        lock.unlock();
+        if (periodicTask) {
+            periodicTask();
+        }
+        if (due) {
+            Result result;
+            compactNow(result);
+        }
+        lock.lock();
+    }
+}
+
+bool HistoryCompactor::isDue() const {
+    auto idle = std::chrono::steady_clock::duration(steadyNow() - lastActivity.load(std::memory_order_relaxed));
+    if (idle < IDLE_DELAY) {
+        return false;
+    }
+    if (!checked) {
+        return true;
+    }
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(path, ec);
+    return !ec && size >= compactedSize + GROWTH_THRESHOLD;
+}
@@ -0,0 +1,64 @@
+#ifndef HISTORYCOMPACTOR_H
+#define HISTORYCOMPACTOR_H
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+class HistoryCompactor {
+public:
+    struct Result {
+        size_t recordsBefore = 0;
+        size_t recordsAfter = 0;
+        uint64_t bytesBefore = 0;
+        uint64_t bytesAfter = 0;
+        size_t archived = 0;
+        bool rewritten = false;
+    };
+
+    HistoryCompactor();
+    ~HistoryCompactor();
+    HistoryCompactor(const HistoryCompactor&) = delete;
+    HistoryCompactor& operator=(const HistoryCompactor&) = delete;
+
+    void start(const std::filesystem::path& file, const std::filesystem::path& archiveDirectory);
+    void stop();
+    void notifyActivity();
+    void setPeriodicTask(std::function<void()> task);
+    bool compactNow(Result& result);
+
+    void setLimits(size_t maxEntries, uint32_t maxAgeDays);
+    size_t getMaxEntries() const;
+    uint32_t getMaxAgeDays() const;
+
+    static bool compact(const std::filesystem::path& file, const std::filesystem::path& archiveDirectory, size_t maxEntries, uint32_t maxAgeDays, Result& result);
+
+private:
+    void run();
+    bool isDue() const;
+
+    std::filesystem::path path;
+    std::filesystem::path archivePath;
+    std::thread worker;
+    std::function<void()> periodicTask;
+    std::mutex mutex;
+    std::mutex compactionMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::atomic<int64_t> lastActivity;
+    std::atomic<size_t> maxEntries;
+    std::atomic<uint32_t> maxAgeDays;
+    uint64_t compactedSize = 0;
+    bool checked = false;
+
+    static constexpr std::chrono::seconds IDLE_DELAY{5};
+    static constexpr std::chrono::seconds POLL_INTERVAL{1};
+    static const uint64_t GROWTH_THRESHOLD = 64 * 1024;
+};
+
+#endif // HISTORYCOMPACTOR_H
@@ -0,0 +1,108 @@
+#include "historysearchindex.h"
+#include "historyarchive.h"
+#include <algorithm>
+
+HistorySearchIndex::HistorySearchIndex() {}
+
+void HistorySearchIndex::update(const MappedHistory& history, const std::filesystem::path& archiveDirectory) {
+    if (!loaded || history.getFileId() != historyId || history.size() < consumedRecords) {
+        entries.clear();
+        postings.clear();
+        HistoryArchive archive;
+        if (archive.open(archiveDirectory)) {
+            for (const HistoryArchive::Segment& segment : archive.getSegments("history")) {
+                archive.forEachRecord(segment, [this](const HistoryRecord& record) {
+                    if (!record.command.empty()) {
+                        entries.push_back(record.command);
+                        indexEntry(entries.size() - 1);
+                    }
+                    return true;
+                });
+            }
+        }
+        entries.reserve(entries.size() + history.size());
+        historyId = history.getFileId();
+        consumedRecords = 0;
+        loaded = true;
+    }
+    HistoryRecord record;
+    for (; consumedRecords < history.size(); consumedRecords++) {
+        if (!history.getRecord(consumedRecords, record) || record.command.empty()) {
+            continue;
+        }
+        entries.push_back(std::move(record.command));
+        indexEntry(entries.size() - 1);
+    }
+}
+
+int HistorySearchIndex::findPrevious(const std::string& query, int before) const {
+    before = std::min(before, size());
+    if (query.empty() || before <= 0) {
+        return -1;
+    }
+    if (query.size() == 1) {
+        for (int i = before - 1; i >= 0; i--) {
+            if (entries[i].find(query) != std::string::npos) {
+                return i;
+            }
+        }
+        return -1;
+    }
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(query.data());
+    size_t gramLength = query.size() == 2 ? 2 : 3;
+    const std::vector<uint32_t>* rarest = nullptr;
+    for (size_t i = 0; i + gramLength <= query.size(); i++) {
+        auto it = postings.find(gramKey(data + i, gramLength));
+        if (it == postings.end()) {
+            return -1;
+        }
+        if (rarest == nullptr || it->second.size() < rarest->size()) {
+            rarest = &it->second;
+        }
+    }
+    auto candidate = std::lower_bound(rarest->begin(), rarest->end(), static_cast<uint32_t>(before));
+    while (candidate != rarest->begin()) {
+        --candidate;
+        if (entries[*candidate].find(query) != std::string::npos) {
+            return *candidate;
+        }
+    }
+    return -1;
+}
+
+const std::string& HistorySearchIndex::getEntry(int index) const {
+    return entries[index];
+}
+
+const std::vector<std::string>& HistorySearchIndex::getEntries() const {
+    return entries;
+}
+
+int HistorySearchIndex::size() const {
+    return static_cast<int>(entries.size());
+}
+
+uint32_t HistorySearchIndex::gramKey(const unsigned char* data, size_t length) {
+    if (length == 2) {
+        return (2u << 24) | (data[0] << 8) | data[1];
+    }
+    return (3u << 24) | (data[0] << 16) | (data[1] << 8) | data[2];
+}
+
+void HistorySearchIndex::indexEntry(uint32_t id) {
+    const std::string& entry = entries[id];
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(entry.data());
+    std::vector<uint32_t> keys;
+    keys.reserve(entry.size() * 2);
+    for (size_t i = 0; i + 2 <= entry.size(); i++) {
+        keys.push_back(gramKey(data + i, 2));
+        if (i + 3 <= entry.size()) {
+            keys.push_back(gramKey(data + i, 3));
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    for (uint32_t key : keys) {
+        postings[key].push_back(id);
+    }
+}
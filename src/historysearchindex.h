@@ -0,0 +1,31 @@
+#ifndef HISTORYSEARCHINDEX_H
+#define HISTORYSEARCHINDEX_H
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <filesystem>
+#include "mappedhistory.h"
+
+class HistorySearchIndex {
+public:
+    HistorySearchIndex();
+
+    void update(const MappedHistory& history, const std::filesystem::path& archiveDirectory);
+    int findPrevious(const std::string& query, int before) const;
+    const std::string& getEntry(int index) const;
+    const std::vector<std::string>& getEntries() const;
+    int size() const;
+
+private:
+    static uint32_t gramKey(const unsigned char* data, size_t length);
+    void indexEntry(uint32_t id);
+
+    std::vector<std::string> entries;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+    uint64_t historyId = 0;
+    size_t consumedRecords = 0;
+    bool loaded = false;
+};
+
+#endif // HISTORYSEARCHINDEX_H
@@ -0,0 +1,172 @@
+#include "historywriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+HistoryWriter::HistoryWriter() : lastSync(std::chrono::steady_clock::now()) {}
+
+HistoryWriter::~HistoryWriter() {
+    close();
+}
+
+bool HistoryWriter::open(const std::filesystem::path& file, const std::string& header) {
+    close();
+    path = file;
+    fileHeader = header;
+    fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    lastSync = std::chrono::steady_clock::now();
+    if (fd < 0) {
+        return false;
+    }
+    if (fileHeader.empty()) {
+        return true;
+    }
+    if (!lockFile()) {
+        return false;
+    }
+    struct stat info;
+    bool written = ::fstat(fd, &info) == 0 && (info.st_size > 0 || writeAll(fileHeader));
+    ::flock(fd, LOCK_UN);
+    return written;
+}
+
+void HistoryWriter::close() {
+    if (fd < 0) {
+        return;
+    }
+    sync();
+    ::close(fd);
+    fd = -1;
+}
+
+bool HistoryWriter::isOpen() const {
+    return fd >= 0;
+}
+
+bool HistoryWriter::append(const std::function<std::string()>& encodeRecord) {
+    if (fd < 0 || !lockCurrentFile()) {
+        return false;
+    }
+    bool written = writeAll(encodeRecord());
+    ::flock(fd, LOCK_UN);
+    if (!written) {
+        return false;
+    }
+    unsyncedRecords++;
+    if (syncDue()) {
+        sync();
+    }
+    return true;
+}
+
+void HistoryWriter::sync() {
+    if (fd < 0 || unsyncedRecords == 0) {
+        return;
+    }
+    ::fdatasync(fd);
+    unsyncedRecords = 0;
+    lastSync = std::chrono::steady_clock::now();
+}
+
+void HistoryWriter::syncIfDue() {
+    if (syncDue()) {
+        sync();
+    }
+}
+
+void HistoryWriter::setSyncPolicy(SyncPolicy policy, uint64_t value) {
+    this->policy = policy;
+    policyValue = value;
+    if (syncDue()) {
+        sync();
+    }
+}
+
+HistoryWriter::SyncPolicy HistoryWriter::getSyncPolicy() const {
+    return policy;
+}
+
+uint64_t HistoryWriter::getSyncValue() const {
+    return policyValue;
+}
+
+std::string HistoryWriter::getPolicyName(SyncPolicy policy) {
+    switch (policy) {
+        case SyncPolicy::Interval:
+            return "interval";
+        case SyncPolicy::OnExit:
+            return "exit";
+        default:
+            return "commands";
+    }
+}
+
+bool HistoryWriter::parsePolicyName(const std::string& name, SyncPolicy& policy) {
+    if (name == "commands") {
+        policy = SyncPolicy::EveryCommands;
+    } else if (name == "interval") {
+        policy = SyncPolicy::Interval;
+    } else if (name == "exit") {
+        policy = SyncPolicy::OnExit;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool HistoryWriter::lockFile() {
+    while (::flock(fd, LOCK_EX) != 0) {
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HistoryWriter::lockCurrentFile() {
+    while (lockFile()) {
+        struct stat opened;
+        if (::fstat(fd, &opened) == 0 && opened.st_nlink > 0) {
+            return true;
+        }
+        ::flock(fd, LOCK_UN);
+        std::filesystem::path file = path;
+        std::string header = fileHeader;
+        if (!open(file, header)) {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool HistoryWriter::writeAll(const std::string& data) {
+    const char* position = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, position, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        position += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool HistoryWriter::syncDue() const {
+    switch (policy) {
+        case SyncPolicy::EveryCommands:
+            return unsyncedRecords >= std::max<uint64_t>(policyValue, 1);
+        case SyncPolicy::Interval:
+            return unsyncedRecords > 0 &&
+                std::chrono::steady_clock::now() - lastSync >= std::chrono::milliseconds(policyValue);
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef HISTORYWRITER_H
+#define HISTORYWRITER_H
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+
+class HistoryWriter {
+public:
+    enum class SyncPolicy { EveryCommands, Interval, OnExit };
+
+    HistoryWriter();
+    ~HistoryWriter();
+    HistoryWriter(const HistoryWriter&) = delete;
+    HistoryWriter& operator=(const HistoryWriter&) = delete;
+
+    bool open(const std::filesystem::path& file, const std::string& header);
+    void close();
+    bool isOpen() const;
+    bool append(const std::function<std::string()>& encodeRecord);
+    void sync();
+    void syncIfDue();
+
+    void setSyncPolicy(SyncPolicy policy, uint64_t value);
+    SyncPolicy getSyncPolicy() const;
+    uint64_t getSyncValue() const;
+    static std::string getPolicyName(SyncPolicy policy);
+    static bool parsePolicyName(const std::string& name, SyncPolicy& policy);
+
+private:
+    bool lockFile();
+    bool lockCurrentFile();
+    bool writeAll(const std::string& data);
+    bool syncDue() const;
+
+    int fd = -1;
+    std::filesystem::path path;
+    std::string fileHeader;
+    SyncPolicy policy = SyncPolicy::EveryCommands;
+    uint64_t policyValue = 10;
+    uint64_t unsyncedRecords = 0;
+    std::chrono::steady_clock::time_point lastSync;
+};
+
+#endif // HISTORYWRITER_H
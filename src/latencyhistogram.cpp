@@ -0,0 +1,157 @@
+#include "latencyhistogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+LatencyHistogram::LatencyHistogram() : counts(indexFor(HIGHEST_TRACKABLE_VALUE) + 1, 0) {}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    uint64_t value = std::min(nanoseconds, HIGHEST_TRACKABLE_VALUE);
+    counts[indexFor(value)]++;
+    totalCount++;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+}
+
+void LatencyHistogram::reset() {
+    std::fill(counts.begin(), counts.end(), 0);
+    totalCount = 0;
+    minValue = UINT64_MAX;
+    maxValue = 0;
+}
+
+uint64_t LatencyHistogram::getTotalCount() const {
+    return totalCount;
+}
+
+uint64_t LatencyHistogram::getMin() const {
+    return totalCount == 0 ? 0 : minValue;
+}
+
+uint64_t LatencyHistogram::getMax() const {
+    return maxValue;
+}
+
+double LatencyHistogram::getMean() const {
+    if (totalCount == 0) {
+        return 0;
+    }
+    double sum = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        if (counts[i] != 0) {
+            sum += counts[i] * ((lowestValueAt(i) + highestValueAt(i)) / 2.0);
+        }
+    }
+    return sum / totalCount;
+}
+
+double LatencyHistogram::getStandardDeviation() const {
+    if (totalCount == 0) {
+        return 0;
+    }
+    double mean = getMean();
+    double squares = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        if (counts[i] != 0) {
+            double deviation = (lowestValueAt(i) + highestValueAt(i)) / 2.0 - mean;
+            squares += counts[i] * deviation * deviation;
+        }
+    }
+    return std::sqrt(squares / totalCount);
+}
+
+uint64_t LatencyHistogram::getValueAtPercentile(double percentile) const {
+    if (totalCount == 0) {
+        return 0;
+    }
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * totalCount)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= target) {
+            return std::min(highestValueAt(i), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+std::string LatencyHistogram::getSummary() const {
+    if (totalCount == 0) {
+        return "No keystrokes recorded yet.";
+    }
+    std::string summary = "Keystrokes: " + std::to_string(totalCount) + "\n";
+    summary += "Min:    " + formatDuration(getMin()) + "\n";
+    summary += "Mean:   " + formatDuration(getMean()) + "\n";
+    summary += "p50:    " + formatDuration(getValueAtPercentile(50)) + "\n";
+    summary += "p90:    " + formatDuration(getValueAtPercentile(90)) + "\n";
+    summary += "p99:    " + formatDuration(getValueAtPercentile(99)) + "\n";
+    summary += "p99.9:  " + formatDuration(getValueAtPercentile(99.9)) + "\n";
+    summary += "Max:    " + formatDuration(getMax());
+    return summary;
+}
+
+bool LatencyHistogram::exportToFile(const std::filesystem::path& file) const {
+    std::ofstream output(file);
+    if (!output.is_open()) {
+        return false;
+    }
+    char line[128];
+    output << "       Value     Percentile TotalCount 1/(1-Percentile)\n\n";
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        if (counts[i] == 0) {
+            continue;
+        }
+        seen += counts[i];
+        double fraction = static_cast<double>(seen) / totalCount;
+        uint64_t value = std::min(highestValueAt(i), maxValue);
+        if (seen == totalCount) {
+            std::snprintf(line, sizeof(line), "%12.3f %14.12f %10llu\n", value / 1000.0, fraction, static_cast<unsigned long long>(seen));
+        } else {
+            std::snprintf(line, sizeof(line), "%12.3f %14.12f %10llu %14.2f\n", value / 1000.0, fraction, static_cast<unsigned long long>(seen), 1.0 / (1.0 - fraction));
+        }
+        output << line;
+    }
+    std::snprintf(line, sizeof(line), "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n", getMean() / 1000.0, getStandardDeviation() / 1000.0);
+    output << line;
+    std::snprintf(line, sizeof(line), "#[Max     = %12.3f, Total count    = %12llu]\n", getMax() / 1000.0, static_cast<unsigned long long>(totalCount));
+    output << line;
+    output << "#[Values in microseconds, " << SUB_BUCKET_COUNT << " sub-buckets per power of two]\n";
+    return output.good();
+}
+
+size_t LatencyHistogram::indexFor(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+    int shift = (63 - __builtin_clzll(value)) - SUB_BUCKET_BITS;
+    return static_cast<size_t>(shift * SUB_BUCKET_COUNT + (value >> shift));
+}
+
+uint64_t LatencyHistogram::lowestValueAt(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    uint64_t shift = index / SUB_BUCKET_COUNT - 1;
+    return (index - shift * SUB_BUCKET_COUNT) << shift;
+}
+
+uint64_t LatencyHistogram::highestValueAt(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    uint64_t shift = index / SUB_BUCKET_COUNT - 1;
+    return ((index - shift * SUB_BUCKET_COUNT + 1) << shift) - 1;
+}
+
+std::string LatencyHistogram::formatDuration(double nanoseconds) {
+    char buffer[32];
+    if (nanoseconds >= 1000000) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f ms", nanoseconds / 1000000.0);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.1f us", nanoseconds / 1000.0);
+    }
+    return buffer;
+}
@@ -0,0 +1,39 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void record(uint64_t nanoseconds);
+    void reset();
+    uint64_t getTotalCount() const;
+    uint64_t getMin() const;
+    uint64_t getMax() const;
+    double getMean() const;
+    double getStandardDeviation() const;
+    uint64_t getValueAtPercentile(double percentile) const;
+    std::string getSummary() const;
+    bool exportToFile(const std::filesystem::path& file) const;
+
+private:
+    static size_t indexFor(uint64_t value);
+    static uint64_t lowestValueAt(size_t index);
+    static uint64_t highestValueAt(size_t index);
+    static std::string formatDuration(double nanoseconds);
+
+    std::vector<uint64_t> counts;
+    uint64_t totalCount = 0;
+    uint64_t minValue = UINT64_MAX;
+    uint64_t maxValue = 0;
+
+    static constexpr int SUB_BUCKET_BITS = 7;
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;
+    static constexpr uint64_t HIGHEST_TRACKABLE_VALUE = 60ULL * 1000 * 1000 * 1000;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -3,30 +3,47 @@
 #include <thread>
 #include <vector>
 #include <fstream>
+#include <sstream>
 #include <map>
-#include <queue>
+#include <deque>
+#include <unordered_set>
 #include <termios.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
 #include <limits>
+#include <charconv>
+#include <chrono>
+#include <mutex>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/socket.h>
 #include "terminalpassthrough.h"
 #include "nlohmann/json.hpp"
 #include "openaipromptengine.h"
+#include "tabcompleter.h"
+#include "historysearchindex.h"
+#include "fuzzymatcher.h"
+#include "autosuggester.h"
+#include "syntaxhighlighter.h"
+#include "latencyhistogram.h"
+#include "historywriter.h"
+#include "mappedhistory.h"
+#include "historycompactor.h"
+#include "historyarchive.h"
+#include "commandregistry.h"
+#include "commandtokenizer.h"
+#include "commandarena.h"
+#include "session.h"
+#include "shortcutplan.h"
+#include "shortcuttemplate.h"
+#include "workerpool.h"
+#include "daemonsocket.h"
+#include "updatechecker.h"
+#include "startupprofiler.h"
 
 using json = nlohmann::json;
 
-bool TESTING = false;
-bool shotcutsEnabled = true;
-bool startCommandsOn = true;
-bool runningStartup = false;
-bool exitFlag = false;
-bool defaultTextEntryOnAI = false;
-bool usingChatCache = true;
-bool saveLoop = false;
-bool saveOnExit = true;
 bool rawEnabled = false;
-bool displayWholePath = false;
-bool checkForUpdates = true;
 
 const std::string GREEN_COLOR_BOLD = "\033[1;32m";
 const std::string RESET_COLOR = "\033[0m";
@@ -36,28 +53,61 @@ const std::string updateURL = "https://api.github.com/repos/cadenfinley/DevTools
 const std::string githubRepoURL = "https://github.com/CadenFinley/DevToolsTerminal";
 const std::string currentVersion = "1.3.1";
 
-std::string commandPrefix = "!";
-std::string lastCommandParsed;
+std::string currentSuggestion;
 std::string applicationDirectory;
 std::string titleLine = "DevToolsTerminal v" + currentVersion + " - Caden Finley (c) 2025";
 std::string createdLine = "Created 2025 @ " + PURPLE_COLOR_BOLD + "Abilene Christian University" + RESET_COLOR;
 
 std::filesystem::path DATA_DIRECTORY = ".DTT-Data";
 std::filesystem::path USER_DATA = DATA_DIRECTORY / ".USER_DATA.json";
-std::filesystem::path USER_COMMAND_HISTORY = DATA_DIRECTORY / ".USER_COMMAND_HISTORY.txt";
+std::filesystem::path USER_COMMAND_HISTORY = DATA_DIRECTORY / ".USER_COMMAND_HISTORY.bin";
+std::filesystem::path HISTORY_ARCHIVE = DATA_DIRECTORY / "archive";
+const uintmax_t CHAT_LOG_ARCHIVE_BYTES = 256 * 1024;
+const time_t CHAT_LOG_ARCHIVE_AGE = 7 * 86400;
+const int MAX_SCRIPT_DEPTH = 16;
+const size_t MAX_PARALLEL_STEPS = 32;
+std::filesystem::path DAEMON_SOCKET = DATA_DIRECTORY / "daemon.sock";
+std::filesystem::path UPDATE_CHECK_CACHE = DATA_DIRECTORY / ".UPDATE_CHECK.json";
+const time_t UPDATE_CHECK_TTL = 24 * 3600;
+std::filesystem::path LEGACY_USER_COMMAND_HISTORY = DATA_DIRECTORY / ".USER_COMMAND_HISTORY.txt";
 
-std::queue<std::string> commandsQueue;
-std::vector<std::string> startupCommands;
-std::vector<std::string> savedChatCache;
+// Line editor state, only used by the thread that owns the interactive prompt.
 std::vector<std::string> commandLines;
-std::map<std::string, std::string> shortcuts;
-std::map<std::string, std::vector<std::string>> multiScriptShortcuts;
+TabCompleter tabCompleter;
+HistorySearchIndex historySearchIndex;
+AutoSuggester autoSuggester;
+SyntaxHighlighter syntaxHighlighter;
 
-OpenAIPromptEngine openAIPromptEngine;
-TerminalPassthrough terminal;
+LatencyHistogram keystrokeLatency;
+std::mutex latencyMutex;
+HistoryWriter historyWriter;
+HistoryCompactor historyCompactor;
+CommandRegistry commandRegistry;
+WorkerPool workerPool(MAX_PARALLEL_STEPS);
+UpdateChecker updateChecker(updateURL, currentVersion, UPDATE_CHECK_CACHE, UPDATE_CHECK_TTL);
+StartupProfiler startupProfiler;
+std::mutex historyMutex;
+thread_local Session* session = nullptr;
+volatile sig_atomic_t attachedSessionGroup = 0;
+
+struct LaunchOptions {
+    std::filesystem::path scriptFile;
+    std::string commandText;
+    bool runCommandText = false;
+    bool daemon = false;
+    bool startupProfile = false;
+    std::filesystem::path startupProfileFile;
+};
 
 std::string readAndReturnUserDataFile();
-std::vector<std::string> commandSplicer(const std::string& command);
+bool parseLaunchOptions(const std::vector<std::string>& arguments, LaunchOptions& options, bool topLevel);
+int runBatchSession(const LaunchOptions& options);
+int runInteractiveSession();
+int runDaemon(const LaunchOptions& options);
+void reportStartupProfile(const LaunchOptions& options, const std::string& mode);
+int runAttachedSession(const std::vector<std::string>& request);
+int attachToDaemon(const std::vector<std::string>& arguments);
+void hangUpAttachedSession(int);
 void mainProcessLoop();
 void createNewUSER_DATAFile();
 void createNewUSER_HISTORYfile();
@@ -65,74 +115,115 @@ void loadUserData();
 void writeUserData();
 void goToApplicationDirectory();
 void commandParser(const std::string& command);
-void addUserInputToHistory(const std::string& input);
-void shortcutProcesser(const std::string& command);
-void commandProcesser(const std::string& command);
+int runScript(const std::filesystem::path& file);
+int runCommands(std::istream& input, const std::string& name, bool timed);
+void addUserInputToHistory(const HistoryRecord& record);
+void printUserHistory(const CommandArguments& arguments);
+void archiveChatLogs();
+void listChatLogs();
+void showChatLog(const std::string& name);
+bool isChatLogName(const std::string& name);
+bool promptForMoreOutput(size_t& linesOnPage, size_t pageHeight);
+std::string formatHistoryRecord(const HistoryRecord& record);
+bool parseTimeArgument(const std::string& text, time_t& result);
+void shortcutProcesser(const std::string& name, const std::vector<std::string_view>& arguments);
+void multiScriptShortcutProcesser(const std::string& name, const std::vector<std::string_view>& arguments);
+bool compileShortcut(const std::string& name);
+bool compileMultiScriptShortcut(const std::string& name);
+void addShortcut(const CommandArguments& arguments, bool templated);
+void addMultiScriptShortcut(const CommandArguments& arguments, bool templated);
+void commandProcesser(std::string_view command);
 void sendTerminalCommand(const std::string& command);
-void userSettingsCommands();
-void startupCommandsHandler();
-void shortcutCommands();
-void textCommands();
-void getNextCommand();
-void aiSettingsCommands();
-void aiChatCommands();
+void registerCommands();
+void registerUserCommands();
+void registerUserDataCommands();
+void registerAiCommands();
+void addToggleCommands(const std::string& path, const std::string& label, const std::function<bool()>& getter, const std::function<void(bool)>& setter);
+std::vector<std::string> getShortcutNames();
+std::vector<std::string> getMultiScriptShortcutNames();
+void printStartupCommands();
+void printShortcuts();
+void printActiveFiles();
+void printAvailableFiles();
 void chatProcess(const std::string& message);
 void showChatHistory();
-void multiScriptShortcutCommands();
-void userDataCommands();
 void setRawMode(bool enable);
 void handleArrowKey(char arrow, size_t& cursorPositionX, size_t& cursorPositionY, std::vector<std::string>& commandLines, std::string& command, const std::string& terminalTag);
 void placeCursor(size_t& cursorPositionX, size_t& cursorPositionY);
 void reprintCommandLines(const std::vector<std::string>& commandLines, const std::string& terminalSetting);
 void clearLines(const std::vector<std::string>& commandLines);
-bool checkForUpdate();
+void insertCharacter(char c, size_t& cursorPositionX, size_t& cursorPositionY, int terminalSettingLength);
+void handleTabCompletion(size_t& cursorPositionX, size_t& cursorPositionY, int terminalSettingLength, const std::string& terminalSetting);
+std::vector<std::string> getCommandCompletions(const std::pmr::vector<std::string_view>& commandPath, bool& completePaths);
+bool isKnownCommand(const std::string& name);
+bool isKnownPrefixCommand(const std::string& name);
+bool pathExistsFromCurrentDirectory(const std::string& path);
+bool handleReverseSearch(size_t& cursorPositionX, size_t& cursorPositionY, int terminalSettingLength, const std::string& terminalSetting);
+void handleFuzzyHistorySearch(size_t& cursorPositionX, size_t& cursorPositionY, int terminalSettingLength, const std::string& terminalSetting);
+void replaceCommandLines(const std::string& text, size_t& cursorPositionX, size_t& cursorPositionY, int terminalSettingLength);
+std::string runFuzzyPicker(const std::vector<std::string>& candidates, const std::string& title);
+void showSuggestion(size_t cursorPositionX, size_t cursorPositionY, int terminalSettingLength);
+void acceptSuggestion(size_t& cursorPositionX, size_t& cursorPositionY, int terminalSettingLength, const std::string& terminalSetting);
+void clearSuggestion();
+void recordKeystrokeLatency(std::chrono::steady_clock::time_point readTime);
 bool downloadLatestRelease();
 void displayChangeLog(const std::string& changeLog);
 
-int main() {
-    sendTerminalCommand("clear");
-    std::cout << "Loading..." << std::endl;
+int main(int argc, char* argv[]) {
+    std::vector<std::string> arguments(argv + 1, argv + argc);
+    if (const char* socketPath = std::getenv("DTT_DAEMON_SOCKET")) {
+        DAEMON_SOCKET = socketPath;
+    }
+    if (!arguments.empty() && arguments[0] == "--attach") {
+        return attachToDaemon(std::vector<std::string>(arguments.begin() + 1, arguments.end()));
+    }
+    Session mainSession;
+    session = &mainSession;
+    startupProfiler.begin("command registry");
+    registerCommands();
+    startupProfiler.end();
+    LaunchOptions options;
+    if (!parseLaunchOptions(arguments, options, true)) {
+        return 2;
+    }
+    bool interactive = !options.daemon && options.scriptFile.empty() && !options.runCommandText && isatty(STDIN_FILENO);
+
+    if (interactive) {
+        startupProfiler.begin("screen clear");
+        sendTerminalCommand("clear");
+        std::cout << "Loading..." << std::endl;
 
-    if(checkForUpdates){
-        if (checkForUpdate()) {
-            std::cout << "An update is available. Would you like to download it? (Y/N)" << std::endl;
-            char response;
-            std::cin >> response;
+        startupProfiler.begin("changelog");
+        std::ifstream changelogFile(DATA_DIRECTORY / "CHANGELOG.txt");
+        if (changelogFile.is_open()) {
+            std::cout << "Thanks for downloading the latest version of DevToolsTerminal Version: " << currentVersion << std::endl;
+            std::cout << "Check out the github repo for more information:\n" << githubRepoURL << std::endl;
+            std::cout << "And check me out at CadenFinley.com" << std::endl;
+            std::string changeLog((std::istreambuf_iterator<char>(changelogFile)), std::istreambuf_iterator<char>());
+            changelogFile.close();
+            displayChangeLog(changeLog);
+            std::cout << "Press enter to continue..." << std::endl;
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            if (response == 'Y' || response == 'y') {
-                if (!downloadLatestRelease()) {
-                    std::cout << "Failed to download the update. Please try again later." << std::endl;
-                }
-            }
-        } else {
-            std::cout << "You are up to date!." << std::endl;
+            std::filesystem::remove(DATA_DIRECTORY / "CHANGELOG.txt");
         }
     }
 
-    std::ifstream changelogFile(DATA_DIRECTORY / "CHANGELOG.txt");
-    if (changelogFile.is_open()) {
-        std::cout << "Thanks for downloading the latest version of DevToolsTerminal Version: " << currentVersion << std::endl;
-        std::cout << "Check out the github repo for more information:\n" << githubRepoURL << std::endl;
-        std::cout << "And check me out at CadenFinley.com" << std::endl;
-        std::string changeLog((std::istreambuf_iterator<char>(changelogFile)), std::istreambuf_iterator<char>());
-        changelogFile.close();
-        displayChangeLog(changeLog);
-        std::cout << "Press enter to continue..." << std::endl;
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        std::filesystem::remove(DATA_DIRECTORY / "CHANGELOG.txt");
-    }
-
-    startupCommands = {};
-    shortcuts = {};
-    multiScriptShortcuts = {};
-    terminal = TerminalPassthrough();
-    openAIPromptEngine = OpenAIPromptEngine("", "chat", "You are an AI personal assistant within a terminal application.", {}, ".DTT-Data");
+    startupProfiler.begin("session setup");
+    session->startupCommands = {};
+    session->shortcuts = {};
+    session->shortcutTemplates = {};
+    session->multiScriptShortcuts = {};
+    session->compiledShortcuts = {};
+    session->templatedShortcuts = {};
+    session->templatedMultiScriptShortcuts = {};
+    session->terminal = TerminalPassthrough();
 
     applicationDirectory = std::filesystem::current_path().string();
     if (applicationDirectory.find(":") != std::string::npos) {
         applicationDirectory = applicationDirectory.substr(applicationDirectory.find(":") + 1);
     }
 
+    startupProfiler.begin("user data load");
     if (!std::filesystem::exists(DATA_DIRECTORY)) {
         std::cout << DATA_DIRECTORY.string() << " not found in: " << applicationDirectory << std::endl;
         std::filesystem::create_directory(applicationDirectory / DATA_DIRECTORY);
@@ -144,57 +235,307 @@ int main() {
         loadUserData();
     }
 
+    startupProfiler.begin("history file");
     if (!std::filesystem::exists(USER_COMMAND_HISTORY)) {
-        createNewUSER_HISTORYfile();
+        size_t migrated = 0;
+        if (std::filesystem::exists(LEGACY_USER_COMMAND_HISTORY) &&
+            MappedHistory::migrateTextHistory(LEGACY_USER_COMMAND_HISTORY, USER_COMMAND_HISTORY, migrated)) {
+            std::filesystem::rename(LEGACY_USER_COMMAND_HISTORY, LEGACY_USER_COMMAND_HISTORY.string() + ".migrated");
+            std::cout << "Migrated " << migrated << " history entries to the binary history format." << std::endl;
+        } else {
+            createNewUSER_HISTORYfile();
+        }
+    }
+    startupProfiler.end();
+    if (options.daemon) {
+        return runDaemon(options);
+    }
+    int status = interactive ? runInteractiveSession() : runBatchSession(options);
+    reportStartupProfile(options, interactive ? "interactive" : "batch");
+    return status;
+}
+
+bool parseLaunchOptions(const std::vector<std::string>& arguments, LaunchOptions& options, bool topLevel) {
+    for (size_t i = 0; i < arguments.size(); i++) {
+        const std::string& argument = arguments[i];
+        if (argument == "--script" && i + 1 < arguments.size()) {
+            options.scriptFile = arguments[++i];
+        } else if (argument == "-c" && i + 1 < arguments.size()) {
+            options.commandText = arguments[++i];
+            options.runCommandText = true;
+        } else if (argument == "--daemon" && topLevel) {
+            options.daemon = true;
+        } else if (argument == "--startup-profile" && topLevel) {
+            options.startupProfile = true;
+        } else if (argument.rfind("--startup-profile=", 0) == 0 && topLevel) {
+            options.startupProfile = true;
+            options.startupProfileFile = argument.substr(18);
+        } else {
+            std::cerr << "Error: Unknown argument " << argument << ". Usage: DevToolsTerminal [--startup-profile[=FILE]] [--script FILE | -c COMMAND | --daemon] | --attach [--script FILE | -c COMMAND]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int runBatchSession(const LaunchOptions& options) {
+    startupProfiler.finish();
+    int status;
+    if (!options.scriptFile.empty()) {
+        status = runScript(options.scriptFile);
+    } else if (options.runCommandText) {
+        std::istringstream commands(options.commandText);
+        status = runCommands(commands, "-c", false);
+    } else {
+        status = runCommands(std::cin, "stdin", false);
+    }
+    if (session->saveOnExit) {
+        if (session->hasPromptEngine()) {
+            session->savedChatCache = session->getPromptEngine().getChatCache();
+        }
+        writeUserData();
     }
+    return status;
+}
+
+int runInteractiveSession() {
+    if (session->checkForUpdates) {
+        startupProfiler.begin("update check");
+        updateChecker.start();
+    }
+    startupProfiler.begin("history load");
+    session->terminal.loadPersistedHistory(USER_COMMAND_HISTORY);
+    startupProfiler.begin("history compactor");
+    historyCompactor.setPeriodicTask([] {
+        std::lock_guard<std::mutex> lock(historyMutex);
+        historyWriter.syncIfDue();
+    });
+    historyCompactor.start(USER_COMMAND_HISTORY, HISTORY_ARCHIVE);
 
-    if (!startupCommands.empty() && startCommandsOn) {
-        runningStartup = true;
+    startupProfiler.begin("startup commands");
+    if (!session->startupCommands.empty() && session->startCommandsOn) {
+        session->runningStartup = true;
         std::cout << "Running startup commands..." << std::endl;
-        for (const auto& command : startupCommands) {
-            commandParser(commandPrefix + command);
+        for (const auto& command : session->startupCommands) {
+            commandParser(session->commandPrefix + command);
         }
-        runningStartup = false;
+        session->runningStartup = false;
     }
 
+    startupProfiler.begin("banner");
     std::cout << titleLine << std::endl;
     std::cout << createdLine << std::endl;
 
+    syntaxHighlighter.setClassifiers(isKnownCommand, isKnownPrefixCommand, pathExistsFromCurrentDirectory);
+    startupProfiler.begin("first prompt render");
     mainProcessLoop();
     std::cout << "Exiting..." << std::endl;
-    if(saveOnExit){
-        savedChatCache = openAIPromptEngine.getChatCache();
+    historyCompactor.stop();
+    historyWriter.close();
+    if(session->saveOnExit){
+        if (session->hasPromptEngine()) {
+            session->savedChatCache = session->getPromptEngine().getChatCache();
+        }
         writeUserData();
     }
     setRawMode(false);
     return 0;
 }
 
+int runDaemon(const LaunchOptions& options) {
+    startupProfiler.begin("daemon socket");
+    std::string error;
+    int listener = DaemonSocket::listenAt(DAEMON_SOCKET, error);
+    if (listener < 0) {
+        std::cerr << "Error: Unable to start the daemon: " << error << std::endl;
+        return 1;
+    }
+    startupProfiler.begin("history load");
+    session->terminal.loadPersistedHistory(USER_COMMAND_HISTORY);
+    startupProfiler.begin("warm caches");
+    autoSuggester.update(session->terminal.getPersistedHistory());
+    tabCompleter.isCommand("ls");
+    session->terminal.returnCurrentTerminalPosition();
+    std::error_code ec;
+    auto userDataTime = std::filesystem::last_write_time(USER_DATA, ec);
+    signal(SIGCHLD, SIG_IGN);
+    std::cout << "Daemon listening on " << DAEMON_SOCKET.string() << std::endl;
+    startupProfiler.finish();
+    reportStartupProfile(options, "daemon");
+
+    while (true) {
+        int connection = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Error: The daemon stopped accepting connections." << std::endl;
+            break;
+        }
+        std::vector<std::string> request;
+        int descriptors[DaemonSocket::PASSED_DESCRIPTORS];
+        if (!DaemonSocket::receiveRequest(connection, request, descriptors)) {
+            ::close(connection);
+            continue;
+        }
+        auto currentTime = std::filesystem::last_write_time(USER_DATA, ec);
+        if (!ec && currentTime != userDataTime) {
+            loadUserData();
+            userDataTime = currentTime;
+        }
+        std::cout.flush();
+        std::cerr.flush();
+        pid_t child = fork();
+        if (child == 0) {
+            ::close(listener);
+            signal(SIGCHLD, SIG_DFL);
+            setsid();
+            for (int i = 0; i < DaemonSocket::PASSED_DESCRIPTORS; i++) {
+                dup2(descriptors[i], i);
+                if (descriptors[i] != i) {
+                    ::close(descriptors[i]);
+                }
+            }
+            signal(SIGIO, hangUpAttachedSession);
+            fcntl(connection, F_SETOWN, getpid());
+            fcntl(connection, F_SETFL, fcntl(connection, F_GETFL) | O_ASYNC);
+            DaemonSocket::sendValue(connection, getpid());
+            int status = runAttachedSession(request);
+            std::cout.flush();
+            std::cerr.flush();
+            DaemonSocket::sendValue(connection, status);
+            std::exit(status);
+        }
+        if (child < 0) {
+            std::cerr << "Error: Unable to start a session for a client." << std::endl;
+        }
+        for (int i = 0; i < DaemonSocket::PASSED_DESCRIPTORS; i++) {
+            ::close(descriptors[i]);
+        }
+        ::close(connection);
+    }
+    ::close(listener);
+    std::filesystem::remove(DAEMON_SOCKET, ec);
+    return 1;
+}
+
+int runAttachedSession(const std::vector<std::string>& request) {
+    LaunchOptions options;
+    if (request.empty() || !parseLaunchOptions(std::vector<std::string>(request.begin() + 1, request.end()), options, false)) {
+        return 2;
+    }
+    std::filesystem::path clientDirectory = request[0];
+    if (!options.scriptFile.empty() && options.scriptFile.is_relative()) {
+        options.scriptFile = clientDirectory / options.scriptFile;
+    }
+    session->terminal.executeCommand("cd " + clientDirectory.string()).join();
+    session->terminal.clearTerminalCache();
+    if (!options.scriptFile.empty() || options.runCommandText || !isatty(STDIN_FILENO)) {
+        return runBatchSession(options);
+    }
+    return runInteractiveSession();
+}
+
+void reportStartupProfile(const LaunchOptions& options, const std::string& mode) {
+    if (!options.startupProfile) {
+        return;
+    }
+    startupProfiler.finish();
+    if (options.startupProfileFile.empty()) {
+        std::cerr << startupProfiler.getSummary() << std::endl;
+    } else if (!startupProfiler.exportToFile(options.startupProfileFile, currentVersion, mode)) {
+        std::cerr << "Error: Unable to write the startup profile to " << options.startupProfileFile.string() << std::endl;
+    }
+}
+
+void hangUpAttachedSession(int) {
+    signal(SIGHUP, SIG_IGN);
+    kill(0, SIGHUP);
+    _exit(129);
+}
+
+void forwardSignal(int signal) {
+    if (attachedSessionGroup > 0) {
+        kill(-attachedSessionGroup, signal);
+    }
+}
+
+int attachToDaemon(const std::vector<std::string>& arguments) {
+    int connection = DaemonSocket::connectTo(DAEMON_SOCKET);
+    if (connection < 0) {
+        std::cerr << "Error: No daemon is listening on " << DAEMON_SOCKET.string() << ". Start one with DevToolsTerminal --daemon." << std::endl;
+        return 1;
+    }
+    std::error_code ec;
+    std::vector<std::string> request = arguments;
+    request.insert(request.begin(), std::filesystem::current_path(ec).string());
+    struct termios saved;
+    bool restoreTerminal = isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &saved) == 0;
+    int descriptors[DaemonSocket::PASSED_DESCRIPTORS] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+    int32_t group = 0;
+    if (!DaemonSocket::sendRequest(connection, request, descriptors) || !DaemonSocket::receiveValue(connection, group)) {
+        std::cerr << "Error: The daemon did not accept the session." << std::endl;
+        ::close(connection);
+        return 1;
+    }
+    attachedSessionGroup = group;
+    struct sigaction action = {};
+    action.sa_handler = forwardSignal;
+    sigemptyset(&action.sa_mask);
+    for (int forwarded : {SIGINT, SIGQUIT, SIGTERM, SIGHUP, SIGWINCH}) {
+        sigaction(forwarded, &action, nullptr);
+    }
+    int32_t status = 1;
+    if (!DaemonSocket::receiveValue(connection, status)) {
+        status = 1;
+    }
+    if (restoreTerminal) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+    }
+    ::close(connection);
+    return status;
+}
+
 int getTerminalWidth(){
     struct winsize w;
     ioctl(STDOUT_FILENO, TIOCGWINSZ, &w);
     return w.ws_col;
 }
 
+int getTerminalHeight(){
+    struct winsize w;
+    ioctl(STDOUT_FILENO, TIOCGWINSZ, &w);
+    return w.ws_row;
+}
+
 void mainProcessLoop() {
     std::string terminalSetting;
     int terminalSettingLength;
     setRawMode(true);
     while (true) {
-        if (saveLoop) {
+        if (session->saveLoop) {
             writeUserData();
         }
-        if (TESTING) {
+        if (session->testing) {
             std::cout << RED_COLOR_BOLD << "DEV MODE ENABLED" << RESET_COLOR << std::endl;
         }
-        if (defaultTextEntryOnAI) {
+        std::string latestVersion;
+        if (session->checkForUpdates && updateChecker.takeNotice(latestVersion)) {
+            std::cout << "An update is available: " << currentVersion << " -> " << latestVersion << ". Run " << session->commandPrefix << "user update to download it." << std::endl;
+        }
+        if (session->defaultTextEntryOnAI) {
             terminalSetting = GREEN_COLOR_BOLD + "AI Menu: " + RESET_COLOR;
             terminalSettingLength = 9;
         } else {
-            terminalSetting = terminal.returnCurrentTerminalPosition();
-            terminalSettingLength = terminal.getTerminalCurrentPositionRawLength();
+            terminalSetting = session->terminal.returnCurrentTerminalPosition();
+            terminalSettingLength = session->terminal.getTerminalCurrentPositionRawLength();
         }
+        session->terminal.refreshPersistedHistory();
         std::cout << terminalSetting;
+        startupProfiler.finish();
+        syntaxHighlighter.setCommandPrefix(session->commandPrefix);
+        syntaxHighlighter.setShellMode(!session->defaultTextEntryOnAI);
+        syntaxHighlighter.reset();
         char c;
         size_t cursorPositionX = 0;
         size_t cursorPositionY = 0;
@@ -202,15 +543,38 @@ void mainProcessLoop() {
         commandLines.push_back("");
         while (true) {
             std::cin.get(c);
+            auto keyReadTime = std::chrono::steady_clock::now();
+            historyCompactor.notifyActivity();
+            if (c != '\033') {
+                clearSuggestion();
+            }
             if (c == '\033') {
                 std::cin.get(c);
                 if (c == '[') {
                     std::cin.get(c);
-                    handleArrowKey(c, cursorPositionX, cursorPositionY, commandLines, commandLines[cursorPositionY], terminalSetting);
+                    if (c == 'C' && !currentSuggestion.empty()) {
+                        acceptSuggestion(cursorPositionX, cursorPositionY, terminalSettingLength, terminalSetting);
+                    } else {
+                        clearSuggestion();
+                        handleArrowKey(c, cursorPositionX, cursorPositionY, commandLines, commandLines[cursorPositionY], terminalSetting);
+                    }
                 }
             } else if (c == '\n') {
                 std::cout << std::endl;
+                recordKeystrokeLatency(keyReadTime);
                 break;
+            } else if (c == '\t') {
+                handleTabCompletion(cursorPositionX, cursorPositionY, terminalSettingLength, terminalSetting);
+                showSuggestion(cursorPositionX, cursorPositionY, terminalSettingLength);
+            } else if (c == 18) {
+                if (handleReverseSearch(cursorPositionX, cursorPositionY, terminalSettingLength, terminalSetting)) {
+                    std::cout << std::endl;
+                    break;
+                }
+                continue;
+            } else if (c == 6) {
+                handleFuzzyHistorySearch(cursorPositionX, cursorPositionY, terminalSettingLength, terminalSetting);
+                continue;
             } else if (c == 127) {
                 clearLines(commandLines);
                 if (commandLines[cursorPositionY].length() > 0 && cursorPositionX > 0) {
@@ -224,25 +588,15 @@ void mainProcessLoop() {
                 }
                 reprintCommandLines(commandLines, terminalSetting);
                 placeCursor(cursorPositionX, cursorPositionY);
+                showSuggestion(cursorPositionX, cursorPositionY, terminalSettingLength);
             } else {
                 clearLines(commandLines);
-                commandLines[cursorPositionY].insert(cursorPositionX, 1, c);
-                int currentLineLength;
-                if(cursorPositionY == 0){
-                    currentLineLength = commandLines[cursorPositionY].length() + terminalSettingLength;
-                } else {
-                    currentLineLength = commandLines[cursorPositionY].length();
-                }
-                if (currentLineLength < getTerminalWidth()) {
-                    cursorPositionX++;
-                } else {
-                    cursorPositionY++;
-                    commandLines.push_back("");
-                    cursorPositionX = 0;
-                }
+                insertCharacter(c, cursorPositionX, cursorPositionY, terminalSettingLength);
                 reprintCommandLines(commandLines, terminalSetting);
                 placeCursor(cursorPositionX, cursorPositionY);
+                showSuggestion(cursorPositionX, cursorPositionY, terminalSettingLength);
             }
+            recordKeystrokeLatency(keyReadTime);
         }
         std::string finalCommand;
         for (const auto& line : commandLines) {
@@ -250,13 +604,62 @@ void mainProcessLoop() {
         }
         setRawMode(false);
         commandParser(finalCommand);
+        historyCompactor.notifyActivity();
         setRawMode(true);
-        if (exitFlag) {
+        if (session->exitFlag) {
             break;
         }
     }
 }
 
+void showSuggestion(size_t cursorPositionX, size_t cursorPositionY, int terminalSettingLength) {
+    currentSuggestion.clear();
+    if (cursorPositionY != commandLines.size() - 1 || cursorPositionX != commandLines[cursorPositionY].length()) {
+        return;
+    }
+    autoSuggester.update(session->terminal.getPersistedHistory());
+    std::string line;
+    for (const auto& commandLine : commandLines) {
+        line += commandLine;
+    }
+    std::string suggestion = autoSuggester.suggest(line, session->terminal.getCurrentFilePath());
+    if (suggestion.length() <= line.length()) {
+        return;
+    }
+    int rowLength = commandLines[cursorPositionY].length() + (cursorPositionY == 0 ? terminalSettingLength : 0);
+    int availableWidth = getTerminalWidth() - rowLength - 1;
+    if (availableWidth <= 0) {
+        return;
+    }
+    currentSuggestion = suggestion.substr(line.length());
+    std::string ghostText = currentSuggestion.substr(0, availableWidth);
+    std::cout << "\033[2m" << ghostText << RESET_COLOR << "\033[" << ghostText.length() << "D" << std::flush;
+}
+
+void acceptSuggestion(size_t& cursorPositionX, size_t& cursorPositionY, int terminalSettingLength, const std::string& terminalSetting) {
+    std::string accepted = currentSuggestion;
+    clearSuggestion();
+    clearLines(commandLines);
+    for (char c : accepted) {
+        insertCharacter(c, cursorPositionX, cursorPositionY, terminalSettingLength);
+    }
+    reprintCommandLines(commandLines, terminalSetting);
+    placeCursor(cursorPositionX, cursorPositionY);
+}
+
+void recordKeystrokeLatency(std::chrono::steady_clock::time_point readTime) {
+    std::cout.flush();
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    keystrokeLatency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - readTime).count());
+}
+
+void clearSuggestion() {
+    if (!currentSuggestion.empty()) {
+        std::cout << "\033[K";
+        currentSuggestion.clear();
+    }
+}
+
 void clearLines(const std::vector<std::string>& commandLines){
     std::cout << "\033[2K\r";
     if(commandLines.size() > 1){
@@ -269,13 +672,326 @@ void clearLines(const std::vector<std::string>& commandLines){
     }
 }
 
+void insertCharacter(char c, size_t& cursorPositionX, size_t& cursorPositionY, int terminalSettingLength) {
+    commandLines[cursorPositionY].insert(cursorPositionX, 1, c);
+    int currentLineLength;
+    if(cursorPositionY == 0){
+        currentLineLength = commandLines[cursorPositionY].length() + terminalSettingLength;
+    } else {
+        currentLineLength = commandLines[cursorPositionY].length();
+    }
+    if (currentLineLength < getTerminalWidth()) {
+        cursorPositionX++;
+    } else {
+        cursorPositionY++;
+        commandLines.push_back("");
+        cursorPositionX = 0;
+    }
+}
+
+void handleTabCompletion(size_t& cursorPositionX, size_t& cursorPositionY, int terminalSettingLength, const std::string& terminalSetting) {
+    std::string textBeforeCursor;
+    for (size_t i = 0; i < cursorPositionY; i++) {
+        textBeforeCursor += commandLines[i];
+    }
+    textBeforeCursor += commandLines[cursorPositionY].substr(0, cursorPositionX);
+    size_t wordStart = textBeforeCursor.find_last_of(' ');
+    std::string currentWord = wordStart == std::string::npos ? textBeforeCursor : textBeforeCursor.substr(wordStart + 1);
+    CommandTokenizer tokenizer;
+    std::string previousText = wordStart == std::string::npos ? "" : textBeforeCursor.substr(0, wordStart);
+    std::pmr::vector<std::string_view> previousWords = tokenizer.tokenize(previousText);
+
+    bool shellContext = !session->defaultTextEntryOnAI;
+    CompletionResult result;
+    if (textBeforeCursor.rfind(session->commandPrefix, 0) == 0) {
+        if (previousWords.empty()) {
+            currentWord = currentWord.substr(session->commandPrefix.length());
+        } else {
+            previousWords[0] = previousWords[0].substr(session->commandPrefix.length());
+        }
+        if (!previousWords.empty() && previousWords[0] == "terminal") {
+            previousWords.erase(previousWords.begin());
+            shellContext = true;
+        } else {
+            shellContext = false;
+            bool completePaths = false;
+            std::vector<std::string> candidates = getCommandCompletions(previousWords, completePaths);
+            if (completePaths) {
+                result = tabCompleter.completePath(session->terminal.getCurrentFilePath(), currentWord);
+            } else {
+                result = TabCompleter::completeFromList(candidates, currentWord);
+            }
+        }
+    }
+    if (shellContext) {
+        if (previousWords.empty() && currentWord.find('/') == std::string::npos) {
+            result = tabCompleter.completeCommandName(currentWord);
+        } else {
+            result = tabCompleter.completePath(session->terminal.getCurrentFilePath(), currentWord);
+        }
+    }
+
+    if (result.totalMatches == 0) {
+        std::cout << "\a" << std::flush;
+        return;
+    }
+    std::string completion;
+    if (result.commonPrefix.length() > currentWord.length()) {
+        completion = result.commonPrefix.substr(currentWord.length());
+    }
+    if (result.totalMatches == 1 && result.commonPrefix.back() != '/') {
+        completion += " ";
+    }
+    if (!completion.empty()) {
+        clearLines(commandLines);
+        for (char c : completion) {
+            insertCharacter(c, cursorPositionX, cursorPositionY, terminalSettingLength);
+        }
+        reprintCommandLines(commandLines, terminalSetting);
+        placeCursor(cursorPositionX, cursorPositionY);
+        return;
+    }
+    for (size_t i = cursorPositionY + 1; i < commandLines.size(); i++) {
+        std::cout << "\033[B";
+    }
+    std::cout << std::endl;
+    size_t terminalWidth = static_cast<size_t>(std::max(getTerminalWidth(), 0));
+    size_t lineWidth = 0;
+    for (const auto& match : result.matches) {
+        if (lineWidth > 0 && lineWidth + match.length() + 2 > terminalWidth) {
+            std::cout << std::endl;
+            lineWidth = 0;
+        }
+        std::cout << match << "  ";
+        lineWidth += match.length() + 2;
+    }
+    std::cout << std::endl;
+    if (result.totalMatches > result.matches.size()) {
+        std::cout << "... and " << result.totalMatches - result.matches.size() << " more" << std::endl;
+    }
+    reprintCommandLines(commandLines, terminalSetting);
+    placeCursor(cursorPositionX, cursorPositionY);
+}
+
+std::vector<std::string> getCommandCompletions(const std::pmr::vector<std::string_view>& commandPath, bool& completePaths) {
+    return commandRegistry.getCompletions(commandPath, completePaths);
+}
+
+bool isKnownCommand(const std::string& name) {
+    if (name.find('/') == std::string::npos) {
+        return tabCompleter.isCommand(name);
+    }
+    std::filesystem::path resolved = name[0] == '/' ? std::filesystem::path(name) : std::filesystem::path(session->terminal.getCurrentFilePath()) / name;
+    return access(resolved.c_str(), X_OK) == 0 && !std::filesystem::is_directory(resolved);
+}
+
+bool isKnownPrefixCommand(const std::string& name) {
+    return commandRegistry.isCommand(name);
+}
+
+bool pathExistsFromCurrentDirectory(const std::string& path) {
+    std::filesystem::path resolved;
+    if (path[0] == '~') {
+        const char* home = std::getenv("HOME");
+        if (home == nullptr) {
+            return false;
+        }
+        resolved = std::string(home) + path.substr(1);
+    } else if (path[0] == '/') {
+        resolved = path;
+    } else {
+        resolved = std::filesystem::path(session->terminal.getCurrentFilePath()) / path;
+    }
+    std::error_code ec;
+    return std::filesystem::exists(resolved, ec);
+}
+
+bool handleReverseSearch(size_t& cursorPositionX, size_t& cursorPositionY, int terminalSettingLength, const std::string& terminalSetting) {
+    session->terminal.refreshPersistedHistory();
+    historySearchIndex.update(session->terminal.getPersistedHistory(), HISTORY_ARCHIVE);
+    std::string query;
+    int matchIndex = -1;
+    bool failed = false;
+    bool execute = false;
+    char c;
+    clearLines(commandLines);
+    while (true) {
+        std::string searchTag = failed ? "(failed reverse-i-search)`" : "(reverse-i-search)`";
+        searchTag += query + "': ";
+        std::string match = matchIndex >= 0 ? historySearchIndex.getEntry(matchIndex) : "";
+        int availableWidth = getTerminalWidth() - static_cast<int>(searchTag.length()) - 1;
+        if (availableWidth > 0 && match.length() > static_cast<size_t>(availableWidth)) {
+            match = match.substr(0, availableWidth);
+        }
+        std::cout << "\033[2K\r" << searchTag << match << std::flush;
+        std::cin.get(c);
+        if (c == 18) {
+            if (query.empty()) {
+                continue;
+            }
+            const std::string current = matchIndex >= 0 ? historySearchIndex.getEntry(matchIndex) : "";
+            int next = matchIndex >= 0 ? matchIndex : historySearchIndex.size();
+            do {
+                next = historySearchIndex.findPrevious(query, next);
+            } while (next >= 0 && historySearchIndex.getEntry(next) == current);
+            if (next >= 0) {
+                matchIndex = next;
+            }
+            failed = next < 0;
+        } else if (c == 127) {
+            if (!query.empty()) {
+                query.pop_back();
+            }
+            matchIndex = historySearchIndex.findPrevious(query, historySearchIndex.size());
+            failed = !query.empty() && matchIndex < 0;
+        } else if (c == 7) {
+            matchIndex = -1;
+            break;
+        } else if (c == '\n') {
+            execute = matchIndex >= 0;
+            break;
+        } else if (c == '\033') {
+            std::cin.get(c);
+            if (c == '[') {
+                std::cin.get(c);
+            }
+            break;
+        } else if (c >= 32 && c < 127) {
+            query += c;
+            int start = matchIndex >= 0 ? matchIndex + 1 : historySearchIndex.size();
+            int found = historySearchIndex.findPrevious(query, start);
+            if (found >= 0) {
+                matchIndex = found;
+            }
+            failed = found < 0;
+        } else {
+            break;
+        }
+    }
+    std::cout << "\033[2K\r";
+    if (matchIndex >= 0) {
+        replaceCommandLines(historySearchIndex.getEntry(matchIndex), cursorPositionX, cursorPositionY, terminalSettingLength);
+    }
+    reprintCommandLines(commandLines, terminalSetting);
+    placeCursor(cursorPositionX, cursorPositionY);
+    return execute;
+}
+
+void handleFuzzyHistorySearch(size_t& cursorPositionX, size_t& cursorPositionY, int terminalSettingLength, const std::string& terminalSetting) {
+    session->terminal.refreshPersistedHistory();
+    historySearchIndex.update(session->terminal.getPersistedHistory(), HISTORY_ARCHIVE);
+    const std::vector<std::string>& entries = historySearchIndex.getEntries();
+    std::vector<std::string> candidates;
+    std::unordered_set<std::string> seen;
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        if (seen.insert(*it).second) {
+            candidates.push_back(*it);
+        }
+    }
+    clearLines(commandLines);
+    std::string chosen = runFuzzyPicker(candidates, "history");
+    if (!chosen.empty()) {
+        replaceCommandLines(chosen, cursorPositionX, cursorPositionY, terminalSettingLength);
+    }
+    reprintCommandLines(commandLines, terminalSetting);
+    placeCursor(cursorPositionX, cursorPositionY);
+}
+
+void replaceCommandLines(const std::string& text, size_t& cursorPositionX, size_t& cursorPositionY, int terminalSettingLength) {
+    commandLines.clear();
+    commandLines.push_back("");
+    cursorPositionX = 0;
+    cursorPositionY = 0;
+    for (char c : text) {
+        insertCharacter(c, cursorPositionX, cursorPositionY, terminalSettingLength);
+    }
+}
+
+std::string runFuzzyPicker(const std::vector<std::string>& candidates, const std::string& title) {
+    const size_t visibleResults = 10;
+    bool wasRaw = rawEnabled;
+    if (!wasRaw) {
+        setRawMode(true);
+    }
+    FuzzyMatcher fuzzyMatcher;
+    std::vector<FuzzyMatch> matches;
+    std::string query;
+    std::string chosen;
+    size_t selected = 0;
+    bool queryChanged = true;
+    char c;
+    while (true) {
+        if (queryChanged) {
+            fuzzyMatcher.setQuery(query);
+            matches = fuzzyMatcher.rank(candidates, visibleResults);
+            selected = 0;
+            queryChanged = false;
+        }
+        int width = getTerminalWidth();
+        std::cout << "\r\033[J" << GREEN_COLOR_BOLD << title << "> " << RESET_COLOR << query;
+        for (size_t i = 0; i < matches.size(); i++) {
+            std::string entry = candidates[matches[i].index];
+            if (width > 3 && entry.length() > static_cast<size_t>(width - 3)) {
+                entry = entry.substr(0, width - 3);
+            }
+            std::cout << "\n" << (i == selected ? GREEN_COLOR_BOLD + "> " : "  ") << entry << RESET_COLOR;
+        }
+        if (!matches.empty()) {
+            std::cout << "\033[" << matches.size() << "A";
+        }
+        std::cout << "\r\033[" << title.length() + 2 + query.length() << "C" << std::flush;
+        std::cin.get(c);
+        if (c == '\n') {
+            if (!matches.empty()) {
+                chosen = candidates[matches[selected].index];
+            }
+            break;
+        } else if (c == 7) {
+            break;
+        } else if (c == 127) {
+            if (!query.empty()) {
+                query.pop_back();
+                queryChanged = true;
+            }
+        } else if (c == 16 && selected > 0) {
+            selected--;
+        } else if (c == 14 && selected + 1 < matches.size()) {
+            selected++;
+        } else if (c == '\033') {
+            std::cin.get(c);
+            if (c == '[') {
+                std::cin.get(c);
+                if (c == 'A' && selected > 0) {
+                    selected--;
+                } else if (c == 'B' && selected + 1 < matches.size()) {
+                    selected++;
+                }
+            }
+        } else if (c >= 32 && c < 127) {
+            query += c;
+            queryChanged = true;
+        }
+    }
+    std::cout << "\r\033[J" << std::flush;
+    if (!wasRaw) {
+        setRawMode(false);
+    }
+    return chosen;
+}
+
 void reprintCommandLines(const std::vector<std::string>& commandLines, const std::string& terminalSetting) {
+    std::string line;
+    for (const auto& commandLine : commandLines) {
+        line += commandLine;
+    }
+    syntaxHighlighter.update(line);
+    size_t offset = 0;
     for (int i = 0; i < commandLines.size(); i++) {
         if (i == 0) {
-            std::cout << terminalSetting << commandLines[i];
-        } else {
-            std::cout << commandLines[i];
+            std::cout << terminalSetting;
         }
+        std::cout << syntaxHighlighter.render(offset, offset + commandLines[i].length());
+        offset += commandLines[i].length();
         if (i < commandLines.size() - 1) {
             std::cout << std::endl;
         }
@@ -318,7 +1034,7 @@ void handleArrowKey(char arrow, size_t& cursorPositionX, size_t& cursorPositionY
             clearLines(commandLines);
             commandLines.clear();
             commandLines.push_back("");
-            command = terminal.getPreviousCommand();
+            command = session->terminal.getPreviousCommand();
             cursorPositionX = command.length();
             cursorPositionY = commandLines.size() - 1;
             std::cout << "\033[2K\r" << terminalTag << command;
@@ -327,7 +1043,7 @@ void handleArrowKey(char arrow, size_t& cursorPositionX, size_t& cursorPositionY
             clearLines(commandLines);
             commandLines.clear();
             commandLines.push_back("");
-            command = terminal.getNextCommand();
+            command = session->terminal.getNextCommand();
             cursorPositionX = command.length();
             cursorPositionY = commandLines.size() - 1;
             std::cout << "\033[2K\r" << terminalTag << command;
@@ -359,7 +1075,7 @@ void createNewUSER_DATAFile() {
     std::cout << "User data file not found. Creating new file..." << std::endl;
     std::ofstream file(USER_DATA);
     if (file.is_open()) {
-        startupCommands.push_back("terminal cd /");
+        session->startupCommands.push_back("terminal cd /");
         writeUserData();
         file.close();
     } else {
@@ -369,8 +1085,10 @@ void createNewUSER_DATAFile() {
 
 void createNewUSER_HISTORYfile() {
     std::cout << "User history file not found. Creating new file..." << std::endl;
-    std::ofstream file(USER_COMMAND_HISTORY);
-    if (!file.is_open()) {
+    std::ofstream file(USER_COMMAND_HISTORY, std::ios::binary);
+    if (file.is_open()) {
+        file << MappedHistory::createHeader();
+    } else {
         std::cerr << "Error: Unable to create the user history file at " << USER_COMMAND_HISTORY << std::endl;
     }
 }
@@ -388,29 +1106,56 @@ void loadUserData() {
             json userData;
             file >> userData;
             if(userData.contains("OpenAI_API_KEY")){
-                openAIPromptEngine.setAPIKey(userData["OpenAI_API_KEY"].get<std::string>());
+                session->openAIAPIKey = userData["OpenAI_API_KEY"].get<std::string>();
             }
             if(userData.contains("Chat_Cache")) {
-                savedChatCache = userData["Chat_Cache"].get<std::vector<std::string>>();
-                openAIPromptEngine.setChatCache(savedChatCache);
+                session->savedChatCache = userData["Chat_Cache"].get<std::vector<std::string>>();
+            }
+            if (session->hasPromptEngine()) {
+                session->getPromptEngine().setAPIKey(session->openAIAPIKey);
+                session->getPromptEngine().setChatCache(session->savedChatCache);
             }
             if(userData.contains("Startup_Commands")){
-                startupCommands = userData["Startup_Commands"].get<std::vector<std::string>>();
+                session->startupCommands = userData["Startup_Commands"].get<std::vector<std::string>>();
             }
             if(userData.contains("Shortcuts_Enabled")){
-                shotcutsEnabled = userData["Shortcuts_Enabled"].get<bool>();
+                session->shotcutsEnabled = userData["Shortcuts_Enabled"].get<bool>();
+            }
+            if(userData.contains("Shortcut_Templates")){
+                session->templatedShortcuts = userData["Shortcut_Templates"].get<std::set<std::string>>();
+            }
+            if(userData.contains("Multi_Script_Templates")){
+                session->templatedMultiScriptShortcuts = userData["Multi_Script_Templates"].get<std::set<std::string>>();
             }
             if(userData.contains("Shortcuts")){
-                shortcuts = userData["Shortcuts"].get<std::map<std::string, std::string>>();
+                session->shortcuts = userData["Shortcuts"].get<std::map<std::string, std::string>>();
+                session->shortcutTemplates.clear();
+                for (const auto& [name, command] : session->shortcuts) {
+                    compileShortcut(name);
+                }
             }
             if(userData.contains("Text_Entry")){
-                defaultTextEntryOnAI = userData["Text_Entry"].get<bool>();
+                session->defaultTextEntryOnAI = userData["Text_Entry"].get<bool>();
             }
             if(userData.contains("Command_Prefix")){
-                commandPrefix = userData["Command_Prefix"].get<std::string>();
+                session->commandPrefix = userData["Command_Prefix"].get<std::string>();
             }
             if(userData.contains("Multi_Script_Shortcuts")){
-                multiScriptShortcuts = userData["Multi_Script_Shortcuts"].get<std::map<std::string, std::vector<std::string>>>();
+                session->multiScriptShortcuts = userData["Multi_Script_Shortcuts"].get<std::map<std::string, std::vector<std::string>>>();
+                session->compiledShortcuts.clear();
+                for (const auto& [name, commands] : session->multiScriptShortcuts) {
+                    compileMultiScriptShortcut(name);
+                }
+            }
+            if(userData.contains("History_Sync_Policy") && userData.contains("History_Sync_Value")){
+                HistoryWriter::SyncPolicy policy;
+                if (HistoryWriter::parsePolicyName(userData["History_Sync_Policy"].get<std::string>(), policy)) {
+                    std::lock_guard<std::mutex> lock(historyMutex);
+                    historyWriter.setSyncPolicy(policy, userData["History_Sync_Value"].get<uint64_t>());
+                }
+            }
+            if(userData.contains("History_Max_Entries") && userData.contains("History_Max_Age_Days")){
+                historyCompactor.setLimits(userData["History_Max_Entries"].get<size_t>(), userData["History_Max_Age_Days"].get<uint32_t>());
             }
             file.close();
         }
@@ -429,19 +1174,29 @@ void writeUserData() {
     std::ofstream file(USER_DATA);
     if (file.is_open()) {
         json userData;
-        userData["OpenAI_API_KEY"] = openAIPromptEngine.getAPIKey();
-        userData["Chat_Cache"] = savedChatCache;
-        userData["Startup_Commands"] = startupCommands;
-        userData["Shortcuts_Enabled"] = shotcutsEnabled;
-        userData["Shortcuts"] = shortcuts;
+        userData["OpenAI_API_KEY"] = session->hasPromptEngine() ? session->getPromptEngine().getAPIKey() : session->openAIAPIKey;
+        userData["Chat_Cache"] = session->savedChatCache;
+        userData["Startup_Commands"] = session->startupCommands;
+        userData["Shortcuts_Enabled"] = session->shotcutsEnabled;
+        userData["Shortcuts"] = session->shortcuts;
         userData["Text_Buffer"] = false;
-        userData["Text_Entry"] = defaultTextEntryOnAI;
-        userData["Command_Prefix"] = commandPrefix;
-        userData["Multi_Script_Shortcuts"] = multiScriptShortcuts;
+        userData["Text_Entry"] = session->defaultTextEntryOnAI;
+        userData["Command_Prefix"] = session->commandPrefix;
+        userData["Multi_Script_Shortcuts"] = session->multiScriptShortcuts;
+        userData["Shortcut_Templates"] = session->templatedShortcuts;
+        userData["Multi_Script_Templates"] = session->templatedMultiScriptShortcuts;
+        {
+            std::lock_guard<std::mutex> lock(historyMutex);
+            userData["History_Sync_Policy"] = HistoryWriter::getPolicyName(historyWriter.getSyncPolicy());
+            userData["History_Sync_Value"] = historyWriter.getSyncValue();
+        }
+        userData["History_Max_Entries"] = historyCompactor.getMaxEntries();
+        userData["History_Max_Age_Days"] = historyCompactor.getMaxAgeDays();
         file << userData.dump(4);
         file.close();
     } else {
         std::cerr << "Error: Unable to write to the user data file at " << USER_DATA << std::endl;
+        session->lastCommandStatus = 1;
     }
 }
 
@@ -458,68 +1213,106 @@ std::string readAndReturnUserDataFile() {
         return userData.empty() ? "No data found." : userData;
     } else {
         std::cerr << "Error: Unable to read the user data file at " << USER_DATA << std::endl;
+        session->lastCommandStatus = 1;
         return "";
     }
 }
 
-std::vector<std::string> commandSplicer(const std::string& command) {
-    std::vector<std::string> commands;
-    std::istringstream iss(command);
-    std::string word;
-    std::string combined;
-    bool inQuotes = false;
-    char quoteChar = '\0';
-
-    while (iss >> word) {
-        if (!inQuotes && (word.front() == '\'' || word.front() == '"' || word.front() == '(' || word.front() == '[')) {
-            inQuotes = true;
-            quoteChar = word.front();
-            combined = word.substr(1);
-        } else if (inQuotes && word.back() == quoteChar) {
-            combined += " " + word.substr(0, word.size() - 1);
-            commands.push_back(combined);
-            inQuotes = false;
-            quoteChar = '\0';
-        } else if (inQuotes) {
-            combined += " " + word;
-        } else {
-            commands.push_back(word);
-        }
-    }
-
-    if (inQuotes) {
-        commands.push_back(combined);
-    }
-
-    return commands;
-}
-
 void commandParser(const std::string& command) {
     if (command.empty()) {
         return;
     }
-    if (!runningStartup) {
-        addUserInputToHistory(command);
-    }
-    if (command.rfind(commandPrefix, 0) == 0) {
-        terminal.addCommandToHistory(command);
-        commandProcesser(command.substr(1));
-        return;
-    }
-    if (defaultTextEntryOnAI) {
-        terminal.addCommandToHistory(command);
+    HistoryRecord record;
+    record.directory = session->terminal.getCurrentFilePath();
+    record.command = command;
+    auto startTime = std::chrono::steady_clock::now();
+    session->lastCommandStatus = 0;
+    if (command.rfind(session->commandPrefix, 0) == 0) {
+        session->terminal.addCommandToHistory(command);
+        commandProcesser(std::string_view(command).substr(1));
+    } else if (session->defaultTextEntryOnAI) {
+        session->terminal.addCommandToHistory(command);
         chatProcess(command);
     } else {
         sendTerminalCommand(command);
     }
+    if (!session->runningStartup) {
+        record.durationMs = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count());
+        record.exitStatus = session->lastCommandStatus;
+        addUserInputToHistory(record);
+    }
 }
 
-void addUserInputToHistory(const std::string& input) {
-    std::ofstream file(USER_COMMAND_HISTORY, std::ios_base::app);
-    if (file.is_open()) {
-        file << std::to_string(time(nullptr)) << " " << input << "\n";
-        file.close();
-    } else {
+int runScript(const std::filesystem::path& file) {
+    std::ifstream script(file);
+    if (!script.is_open()) {
+        std::cerr << "Error: Unable to open the script at " << file.string() << std::endl;
+        return 1;
+    }
+    return runCommands(script, file.filename().string(), true);
+}
+
+int runCommands(std::istream& input, const std::string& name, bool timed) {
+    if (session->scriptDepth >= MAX_SCRIPT_DEPTH) {
+        std::cerr << "Error: Scripts are nested more than " << MAX_SCRIPT_DEPTH << " levels deep." << std::endl;
+        return 1;
+    }
+    session->scriptDepth++;
+    std::string line;
+    size_t lineNumber = 0;
+    size_t executed = 0;
+    size_t failed = 0;
+    int status = 0;
+    auto scriptStart = std::chrono::steady_clock::now();
+    while (!session->exitFlag && std::getline(input, line)) {
+        lineNumber++;
+        size_t start = line.find_first_not_of(" \t");
+        size_t end = line.find_last_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') {
+            continue;
+        }
+        std::string command = line.substr(start, end - start + 1);
+        auto lineStart = std::chrono::steady_clock::now();
+        session->lastCommandStatus = 0;
+        if (command.rfind(session->commandPrefix, 0) == 0) {
+            commandProcesser(std::string_view(command).substr(session->commandPrefix.length()));
+        } else {
+            sendTerminalCommand(command);
+        }
+        status = session->lastCommandStatus;
+        executed++;
+        if (status != 0) {
+            failed++;
+        }
+        if (timed) {
+            double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - lineStart).count();
+            char timing[64];
+            snprintf(timing, sizeof(timing), "%.3f ms, status %d", elapsed, status);
+            std::cout << "[" << name << ":" << lineNumber << "] " << timing << ": " << command << std::endl;
+        }
+    }
+    session->scriptDepth--;
+    if (timed) {
+        double total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - scriptStart).count();
+        char summary[64];
+        snprintf(summary, sizeof(summary), "%.3f ms", total);
+        std::cout << "Ran " << executed << " lines from " << name << " in " << summary << ", " << failed << " failed." << std::endl;
+    }
+    session->lastCommandStatus = status;
+    return status;
+}
+
+void addUserInputToHistory(const HistoryRecord& record) {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    if (!historyWriter.isOpen()) {
+        historyWriter.open(USER_COMMAND_HISTORY, MappedHistory::createHeader());
+    }
+    bool appended = historyWriter.append([&record] {
+        HistoryRecord stamped = record;
+        stamped.timestamp = time(nullptr);
+        return MappedHistory::encodeRecord(stamped);
+    });
+    if (!appended) {
         std::cerr << "Error: Unable to write to the user input history file at " << USER_COMMAND_HISTORY << std::endl;
     }
 }
@@ -541,608 +1334,986 @@ inline void trim(std::string &s) {
     ltrim(s);
 }
 
-void shortcutProcesser(const std::string& command) {
-    if (!shotcutsEnabled) {
+void shortcutProcesser(const std::string& name, const std::vector<std::string_view>& arguments) {
+    if (!session->shotcutsEnabled) {
         std::cout << "Shortcuts are disabled." << std::endl;
         return;
     }
-    if (!shortcuts.empty()) {
-        std::string strippedCommand = command.substr(2);
-        trim(strippedCommand);
-        if (strippedCommand.empty()) {
+    if (!session->shortcuts.empty()) {
+        if (name.empty()) {
             std::cout << "No shortcut given." << std::endl;
+            session->lastCommandStatus = 1;
             return;
         }
-        if (shortcuts.find(strippedCommand) != shortcuts.end()) {
-            commandProcesser(shortcuts[strippedCommand]);
+        auto it = session->shortcutTemplates.find(name);
+        if (it != session->shortcutTemplates.end()) {
+            ShortcutTemplate::Arguments values = ShortcutTemplate::parseArguments(arguments, it->second.getParameterNames(), session->terminal.getCurrentFilePath());
+            std::string command;
+            std::string error;
+            if (!it->second.expand(values, command, error)) {
+                std::cerr << "Error: Shortcut " << name << ": " << error << std::endl;
+                session->lastCommandStatus = 2;
+                return;
+            }
+            commandProcesser(command);
         } else {
-            std::cout << "No command for given shortcut: " << strippedCommand << std::endl;
+            std::cout << "No command for given shortcut: " << name << std::endl;
+            session->lastCommandStatus = 1;
         }
     } else {
         std::cout << "No shortcuts have been created." << std::endl;
+        session->lastCommandStatus = 1;
     }
 }
 
-void multiScriptShortcutProcesser(const std::string& command){
-    if (!shotcutsEnabled) {
+void multiScriptShortcutProcesser(const std::string& name, const std::vector<std::string_view>& arguments) {
+    if (!session->shotcutsEnabled) {
         std::cout << "Shortcuts are disabled." << std::endl;
         return;
     }
-    if (!multiScriptShortcuts.empty()) {
-        std::string strippedCommand = command.substr(2);
-        trim(strippedCommand);
-        if (strippedCommand.empty()) {
+    if (!session->multiScriptShortcuts.empty()) {
+        if (name.empty()) {
             std::cout << "No shortcut given." << std::endl;
+            session->lastCommandStatus = 1;
             return;
         }
-        if (multiScriptShortcuts.find(strippedCommand) != multiScriptShortcuts.end()) {
-            for(const auto& command : multiScriptShortcuts[strippedCommand]){
-                commandProcesser(command);
+        if (session->multiScriptShortcuts.find(name) != session->multiScriptShortcuts.end()) {
+            if (session->compiledShortcuts.find(name) == session->compiledShortcuts.end() && !compileMultiScriptShortcut(name)) {
+                session->lastCommandStatus = 2;
+                return;
+            }
+            ShortcutPlan plan = session->compiledShortcuts[name];
+            ShortcutTemplate::Arguments values = ShortcutTemplate::parseArguments(arguments, plan.getParameterNames(), session->terminal.getCurrentFilePath());
+            std::vector<std::string> commands(plan.getSteps().size());
+            for (size_t i = 0; i < commands.size(); i++) {
+                std::string error;
+                if (!plan.getSteps()[i].commandTemplate.expand(values, commands[i], error)) {
+                    std::cerr << "Error: Multi-script shortcut " << name << ", step '" << plan.getSteps()[i].name << "': " << error << std::endl;
+                    session->lastCommandStatus = 2;
+                    return;
+                }
+            }
+            std::mutex outputMutex;
+            Session* owner = session;
+            std::vector<ShortcutPlan::StepResult> results = plan.execute(workerPool, [owner, &plan, &commands, &outputMutex](size_t index) {
+                const ShortcutPlan::Step& step = plan.getSteps()[index];
+                if (!plan.isParallel(step)) {
+                    owner->lastCommandStatus = 0;
+                    commandProcesser(commands[index]);
+                    return owner->lastCommandStatus;
+                }
+                return owner->terminal.executeCapturedCommand(commands[index].substr(9), [&step, &outputMutex](const std::string& line) {
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    std::cout << "[" << step.name << "] " << line << std::endl;
+                });
+            });
+            int status = 0;
+            for (size_t i = 0; i < results.size(); i++) {
+                const ShortcutPlan::Step& step = plan.getSteps()[i];
+                if (status == 0 && !results[i].skipped) {
+                    status = results[i].status;
+                }
+                if (!step.labelled) {
+                    continue;
+                }
+                if (results[i].skipped) {
+                    std::cout << "[" << step.name << "] skipped, a dependency failed" << std::endl;
+                    continue;
+                }
+                char timing[64];
+                snprintf(timing, sizeof(timing), "%.3f ms", results[i].milliseconds);
+                std::cout << "[" << step.name << "] status " << results[i].status << " in " << timing << std::endl;
             }
+            session->lastCommandStatus = status;
         } else {
-            std::cout << "No command for given shortcut: " << strippedCommand << std::endl;
+            std::cout << "No command for given shortcut: " << name << std::endl;
+            session->lastCommandStatus = 1;
         }
     } else {
         std::cout << "No smulti-script shortcuts have been created." << std::endl;
+        session->lastCommandStatus = 1;
     }
 }
 
-void commandProcesser(const std::string& command) {
-    commandsQueue = std::queue<std::string>();
-    auto commands = commandSplicer(command);
-    for (const auto& cmd : commands) {
-        commandsQueue.push(cmd);
+bool compileShortcut(const std::string& name) {
+    ShortcutTemplate shortcutTemplate;
+    std::string error;
+    if (session->templatedShortcuts.count(name) == 0) {
+        shortcutTemplate.compileLiteral(session->shortcuts[name]);
+    } else if (!shortcutTemplate.compile(session->shortcuts[name], error)) {
+        std::cerr << "Error: Shortcut " << name << ": " << error << std::endl;
+        session->shortcutTemplates.erase(name);
+        return false;
     }
-    if (TESTING) {
-        std::cout << "Commands Queue: ";
-        for (const auto& cmd : commands) {
-            std::cout << cmd << " ";
-        }
-        std::cout << std::endl;
+    session->shortcutTemplates[name] = shortcutTemplate;
+    return true;
+}
+
+bool compileMultiScriptShortcut(const std::string& name) {
+    ShortcutPlan plan;
+    std::string error;
+    if (!plan.compile(session->multiScriptShortcuts[name], session->templatedMultiScriptShortcuts.count(name) != 0, error)) {
+        std::cerr << "Error: Multi-script shortcut " << name << ": " << error << std::endl;
+        session->compiledShortcuts.erase(name);
+        return false;
     }
-    if (commandsQueue.empty()) {
-        std::cout << "Unknown command. Please try again." << std::endl;
+    session->compiledShortcuts[name] = plan;
+    return true;
+}
+
+void commandProcesser(std::string_view command) {
+    session->commandArena.begin();
+    {
+        CommandTokenizer tokenizer(&session->commandArena);
+        const std::pmr::vector<std::string_view>& commands = tokenizer.tokenize(command);
+        if (session->testing) {
+            std::cout << "Commands Queue: ";
+            for (const auto& cmd : commands) {
+                std::cout << cmd << " ";
+            }
+            std::cout << std::endl;
+        }
+        if (!commandRegistry.dispatch(commands, command, tokenizer.isComplete(), &session->commandArena)) {
+            session->lastCommandStatus = 2;
+        }
     }
-    getNextCommand();
-    if (lastCommandParsed == "approot") {
+    session->commandArena.end();
+}
+
+void registerCommands() {
+    commandRegistry.add("approot", "Switch to the application directory", [](const CommandArguments&) {
         goToApplicationDirectory();
-    } else if (lastCommandParsed == "clear") {
+    });
+    commandRegistry.add("clear", "Clear the screen and terminal cache", [](const CommandArguments&) {
         std::cout << "Clearing screen and terminal cache..." << std::endl;
         std::cout << "\033[2J\033[1;1H";
-        terminal.clearTerminalCache();
-    } else if(lastCommandParsed == "ss"){
-        shortcutProcesser(command);
-    } else if(lastCommandParsed == "mm"){
-        multiScriptShortcutProcesser(command);
-    } else if (lastCommandParsed == "ai") {
-        aiSettingsCommands();
-    } else if (lastCommandParsed == "user") {
-        userSettingsCommands();
-    } else if (lastCommandParsed == "aihelp"){
-        if (!defaultTextEntryOnAI && !openAIPromptEngine.getAPIKey().empty() ){
-            std::string message = ("I am encountering these errors in the " + terminal.getTerminalName() + " and would like some help solving these issues. User input " + terminal.returnMostRecentUserInput() + " Terminal output " + terminal.returnMostRecentTerminalOutput());
-            if (TESTING) {
+        session->terminal.clearTerminalCache();
+    });
+    commandRegistry.add("ss", "Run a shortcut", [](const CommandArguments& arguments) {
+        std::pmr::vector<std::string_view> values = arguments.getList("ARGUMENTS");
+        shortcutProcesser(std::string(arguments.get("NAME")), std::vector<std::string_view>(values.begin(), values.end()));
+    }, {{"NAME", CommandRegistry::ArgumentType::Text, true, getShortcutNames}, {"ARGUMENTS", CommandRegistry::ArgumentType::Rest, true}});
+    commandRegistry.add("mm", "Run a multi-script shortcut", [](const CommandArguments& arguments) {
+        std::pmr::vector<std::string_view> values = arguments.getList("ARGUMENTS");
+        multiScriptShortcutProcesser(std::string(arguments.get("NAME")), std::vector<std::string_view>(values.begin(), values.end()));
+    }, {{"NAME", CommandRegistry::ArgumentType::Text, true, getMultiScriptShortcutNames}, {"ARGUMENTS", CommandRegistry::ArgumentType::Rest, true}});
+    registerAiCommands();
+    registerUserCommands();
+    commandRegistry.add("aihelp", "Get AI help for recent terminal errors", [](const CommandArguments&) {
+        if (!session->defaultTextEntryOnAI && !session->getPromptEngine().getAPIKey().empty() ){
+            std::string message = ("I am encountering these errors in the " + session->terminal.getTerminalName() + " and would like some help solving these issues. User input " + session->terminal.returnMostRecentUserInput() + " Terminal output " + session->terminal.returnMostRecentTerminalOutput());
+            if (session->testing) {
                 std::cout << message << std::endl;
             }
-            std::cout << openAIPromptEngine.forceDirectChatGPT(message, false) << std::endl;
-            return;
+            std::cout << session->getPromptEngine().forceDirectChatGPT(message, false) << std::endl;
         }
-    } else if(lastCommandParsed == "version") {
+    });
+    commandRegistry.add("version", "Display the current version", [](const CommandArguments&) {
         std::cout << "DevToolsTerminal v" + currentVersion << std::endl;
-    } else if (lastCommandParsed == "terminal") {
-        try {
-            std::string terminalCommand = command.substr(9);
-            sendTerminalCommand(terminalCommand);
-        } catch (std::out_of_range& e) {
-            defaultTextEntryOnAI = false;
-            return;
-        }
-    } else if (lastCommandParsed == "exit") {
-        exitFlag = true;
-    } else if (lastCommandParsed == "help") {
-        std::cout << "Commands:" << std::endl;
-        std::cout << "Command Prefix: " + commandPrefix << std::endl;
-        std::cout << "ai" << std::endl;
-        std::cout << "approot" << std::endl;
-        std::cout << "terminal o[ARGS]" << std::endl;
-        std::cout << "user" << std::endl;
-        std::cout << "exit" << std::endl;
-        std::cout << "clear" << std::endl;
-        std::cout << "help" << std::endl;
-    } else {
-        std::cout << "Unknown command. Please try again or try 'help'." << std::endl;
+    });
+    commandRegistry.add("terminal", "Run a shell command, or switch text entry to the terminal", [](const CommandArguments& arguments) {
+        if (arguments.has("COMMAND")) {
+            sendTerminalCommand(std::string(arguments.get("COMMAND")));
+        } else {
+            session->defaultTextEntryOnAI = false;
+        }
+    }, {{"COMMAND", CommandRegistry::ArgumentType::Line, true}});
+    commandRegistry.add("run", "Run a script of prefix and shell commands with per-line timing", [](const CommandArguments& arguments) {
+        std::filesystem::path file = arguments.get("FILE");
+        if (file.is_relative()) {
+            file = std::filesystem::path(session->terminal.getCurrentFilePath()) / file;
+        }
+        session->lastCommandStatus = runScript(file);
+    }, {{"FILE", CommandRegistry::ArgumentType::Path}});
+    commandRegistry.add("exit", "Exit the application", [](const CommandArguments&) {
+        session->exitFlag = true;
+    });
+    commandRegistry.add("help", "Display available commands", [](const CommandArguments& arguments) {
+        std::cout << "Command Prefix: " + session->commandPrefix << std::endl;
+        commandRegistry.printHelp(arguments.getList("COMMAND"));
+    }, {{"COMMAND", CommandRegistry::ArgumentType::Rest, true}});
+}
+
+void addToggleCommands(const std::string& path, const std::string& label, const std::function<bool()>& getter, const std::function<void(bool)>& setter) {
+    std::string name = label;
+    name[0] = static_cast<char>(std::tolower(static_cast<unsigned char>(name[0])));
+    if (getter) {
+        commandRegistry.add(path, "Show whether " + name + " is enabled", [label, getter](const CommandArguments&) {
+            std::cout << label << " is currently " << (getter() ? "enabled." : "disabled.") << std::endl;
+        });
+    }
+    commandRegistry.add(path + " enable", "Enable " + name, [label, setter](const CommandArguments&) {
+        setter(true);
+        std::cout << label << " enabled." << std::endl;
+    });
+    commandRegistry.add(path + " disable", "Disable " + name, [label, setter](const CommandArguments&) {
+        setter(false);
+        std::cout << label << " disabled." << std::endl;
+    });
+}
+
+std::vector<std::string> getShortcutNames() {
+    std::vector<std::string> names;
+    for (const auto& [name, command] : session->shortcuts) {
+        names.push_back(name);
+    }
+    return names;
+}
+
+std::vector<std::string> getMultiScriptShortcutNames() {
+    std::vector<std::string> names;
+    for (const auto& [name, commands] : session->multiScriptShortcuts) {
+        names.push_back(name);
     }
+    return names;
 }
 
 void sendTerminalCommand(const std::string& command) {
-    if (TESTING) {
+    if (session->testing) {
         std::cout << "Sending Command: " << command << std::endl;
     }
     if(command == "exit"){
-        exitFlag = true;
+        session->exitFlag = true;
         return;
     }
-    std::thread commandThread = terminal.executeCommand(command);
+    std::thread commandThread = session->terminal.executeCommand(command);
     commandThread.join();
+    session->lastCommandStatus = session->terminal.getLastExitStatus();
 }
 
-void userSettingsCommands() {
-    getNextCommand();
-    if (lastCommandParsed.empty()) {
-        std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
-        return;
-    }
-    if (lastCommandParsed == "startup") {
-        startupCommandsHandler();
-        return;
-    }
-    if (lastCommandParsed == "text") {
-        textCommands();
-        return;
-    }
-    if (lastCommandParsed == "shortcut") {
-        shortcutCommands();
-        return;
-    }
-    if (lastCommandParsed == "testing") {
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
+void registerUserCommands() {
+    using ArgumentType = CommandRegistry::ArgumentType;
+    commandRegistry.describe("user", "Manage startup commands, shortcuts, text entry and user data");
+
+    commandRegistry.add("user startup", "List startup commands", [](const CommandArguments&) {
+        printStartupCommands();
+    });
+    commandRegistry.add("user startup add", "Add a command to run at startup", [](const CommandArguments& arguments) {
+        session->startupCommands.emplace_back(arguments.get("COMMAND"));
+        std::cout << "Command added to startup commands." << std::endl;
+    }, {{"COMMAND"}});
+    commandRegistry.add("user startup remove", "Remove a startup command", [](const CommandArguments& arguments) {
+        std::string_view command = arguments.get("COMMAND");
+        auto it = std::remove(session->startupCommands.begin(), session->startupCommands.end(), command);
+        if (it == session->startupCommands.end()) {
+            std::cout << "Command not found in startup commands." << std::endl;
             return;
         }
-        if (lastCommandParsed == "enable") {
-            TESTING = true;
-            std::cout << "Testing mode enabled." << std::endl;
-            return;
-        }
-        if (lastCommandParsed == "disable") {
-            TESTING = false;
-            std::cout << "Testing mode disabled." << std::endl;
-            return;
+        session->startupCommands.erase(it, session->startupCommands.end());
+        std::cout << "Command removed from startup commands." << std::endl;
+    }, {{"COMMAND", ArgumentType::Text, false, [] { return session->startupCommands; }}});
+    commandRegistry.add("user startup clear", "Clear all startup commands", [](const CommandArguments&) {
+        session->startupCommands.clear();
+        std::cout << "Startup commands cleared." << std::endl;
+    });
+    addToggleCommands("user startup", "Startup commands", nullptr, [](bool enabled) { session->startCommandsOn = enabled; });
+    commandRegistry.add("user startup list", "List startup commands", [](const CommandArguments&) {
+        printStartupCommands();
+    });
+    commandRegistry.add("user startup runall", "Run all startup commands now", [](const CommandArguments&) {
+        if (!session->startupCommands.empty()) {
+            std::cout << "Running startup commands..." << std::endl;
+            for (const auto& command : session->startupCommands) {
+                commandParser(session->commandPrefix + command);
+            }
+        } else {
+            std::cout << "No startup commands." << std::endl;
         }
-        std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
-        return;
-    }
-    if (lastCommandParsed == "data") {
-        userDataCommands();
-        return;
-    }
-    if(lastCommandParsed == "saveloop"){
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "Save loop is currently " << (saveLoop ? "enabled." : "disabled.") << std::endl;
+    });
+
+    commandRegistry.describe("user text", "Configure the prompt and text entry");
+    commandRegistry.add("user text commandprefix", "Show or set the command prefix character", [](const CommandArguments& arguments) {
+        if (!arguments.has("PREFIX")) {
+            std::cout << "Command prefix is currently " + session->commandPrefix << std::endl;
             return;
         }
-        if (lastCommandParsed == "enable") {
-            saveLoop = true;
-            std::cout << "Save loop enabled." << std::endl;
+        std::string prefix(arguments.get("PREFIX"));
+        if (prefix.length() > 1) {
+            std::cout << "Invalid command prefix. Must be a single character." << std::endl;
             return;
-        }
-        if (lastCommandParsed == "disable") {
-            saveLoop = false;
-            std::cout << "Save loop disabled." << std::endl;
+        } else if (prefix == " ") {
+            std::cout << "Invalid command prefix. Must not be a space." << std::endl;
             return;
         }
-    }
-    if(lastCommandParsed == "saveonexit"){
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "Save on exit is currently " << (saveOnExit ? "enabled." : "disabled.") << std::endl;
+        session->commandPrefix = prefix;
+        std::cout << "Command prefix set to " + session->commandPrefix << std::endl;
+    }, {{"PREFIX", ArgumentType::Text, true}});
+    addToggleCommands("user text displayfullpath", "Display whole path",
+        [] { return session->terminal.isDisplayWholePath(); }, [](bool enabled) { session->terminal.setDisplayWholePath(enabled); });
+    commandRegistry.add("user text defaultentry", "Show where text without the prefix is sent", [](const CommandArguments&) {
+        std::cout << "Default text entry is currently " << (session->defaultTextEntryOnAI ? "AI." : "terminal.") << std::endl;
+    });
+    commandRegistry.add("user text defaultentry ai", "Send text without the prefix to the AI", [](const CommandArguments&) {
+        session->defaultTextEntryOnAI = true;
+        std::cout << "Default text entry set to AI." << std::endl;
+    });
+    commandRegistry.add("user text defaultentry terminal", "Send text without the prefix to the terminal", [](const CommandArguments&) {
+        session->defaultTextEntryOnAI = false;
+        std::cout << "Default text entry set to terminal." << std::endl;
+    });
+
+    commandRegistry.add("user shortcut", "List shortcuts", [](const CommandArguments&) {
+        printShortcuts();
+    });
+    commandRegistry.add("user shortcut clear", "Clear all shortcuts", [](const CommandArguments&) {
+        session->shortcuts.clear();
+        session->shortcutTemplates.clear();
+        session->templatedShortcuts.clear();
+        std::cout << "Shortcuts cleared." << std::endl;
+    });
+    addToggleCommands("user shortcut", "Shortcuts", nullptr, [](bool enabled) { session->shotcutsEnabled = enabled; });
+    commandRegistry.describe("user shortcut mm", "Manage multi-script shortcuts");
+    commandRegistry.add("user shortcut mm add", "Add a multi-script shortcut", [](const CommandArguments& arguments) {
+        addMultiScriptShortcut(arguments, false);
+    }, {{"NAME"}, {"COMMANDS", ArgumentType::Rest}});
+    commandRegistry.add("user shortcut mm template", "Add a multi-script shortcut with placeholders", [](const CommandArguments& arguments) {
+        addMultiScriptShortcut(arguments, true);
+    }, {{"NAME"}, {"COMMANDS", ArgumentType::Rest}});
+    commandRegistry.add("user shortcut mm remove", "Remove a multi-script shortcut", [](const CommandArguments& arguments) {
+        session->compiledShortcuts.erase(std::string(arguments.get("NAME")));
+        session->templatedMultiScriptShortcuts.erase(std::string(arguments.get("NAME")));
+        if (session->multiScriptShortcuts.erase(std::string(arguments.get("NAME"))) == 0) {
+            std::cout << "Multi-Script Shortcut not found." << std::endl;
             return;
         }
-        if (lastCommandParsed == "enable") {
-            saveOnExit = true;
-            std::cout << "Save on exit enabled." << std::endl;
+        std::cout << "Multi-Script Shortcut removed." << std::endl;
+    }, {{"NAME", ArgumentType::Text, false, getMultiScriptShortcutNames}});
+    commandRegistry.add("user shortcut add", "Add a shortcut", [](const CommandArguments& arguments) {
+        addShortcut(arguments, false);
+    }, {{"SHORTCUT"}, {"COMMAND"}});
+    commandRegistry.add("user shortcut template", "Add a shortcut with placeholders", [](const CommandArguments& arguments) {
+        addShortcut(arguments, true);
+    }, {{"SHORTCUT"}, {"COMMAND"}});
+    commandRegistry.add("user shortcut remove", "Remove a shortcut", [](const CommandArguments& arguments) {
+        session->shortcutTemplates.erase(std::string(arguments.get("SHORTCUT")));
+        session->templatedShortcuts.erase(std::string(arguments.get("SHORTCUT")));
+        if (session->shortcuts.erase(std::string(arguments.get("SHORTCUT"))) == 0) {
+            std::cout << "Shortcut not found." << std::endl;
             return;
         }
-        if (lastCommandParsed == "disable") {
-            saveOnExit = false;
-            std::cout << "Save on exit disabled." << std::endl;
-            return;
+        std::cout << "Shortcut removed." << std::endl;
+    }, {{"SHORTCUT", ArgumentType::Text, false, getShortcutNames}});
+    commandRegistry.add("user shortcut list", "List shortcuts", [](const CommandArguments&) {
+        printShortcuts();
+    });
+
+    addToggleCommands("user testing", "Testing mode", [] { return session->testing; }, [](bool enabled) { session->testing = enabled; });
+    registerUserDataCommands();
+
+    commandRegistry.describe("user stats", "Show performance statistics");
+    commandRegistry.add("user stats latency", "Show the keystroke latency histogram", [](const CommandArguments&) {
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        std::cout << keystrokeLatency.getSummary() << std::endl;
+    });
+    commandRegistry.add("user stats latency export", "Export the keystroke latency histogram", [](const CommandArguments& arguments) {
+        std::filesystem::path exportPath = DATA_DIRECTORY / "keystroke-latency.hgrm";
+        if (arguments.has("FILE")) {
+            exportPath = arguments.get("FILE");
+            if (exportPath.is_relative()) {
+                exportPath = std::filesystem::path(session->terminal.getCurrentFilePath()) / exportPath;
+            }
         }
-    }
-    if(lastCommandParsed == "checkforupdates"){
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "Check for updates is currently " << (checkForUpdates ? "enabled." : "disabled.") << std::endl;
+        std::unique_lock<std::mutex> lock(latencyMutex);
+        bool exported = keystrokeLatency.exportToFile(exportPath);
+        lock.unlock();
+        if (exported) {
+            std::cout << "Latency histogram exported to " << exportPath.string() << std::endl;
+        } else {
+            std::cerr << "Error: Unable to write to " << exportPath.string() << std::endl;
+            session->lastCommandStatus = 1;
+        }
+    }, {{"FILE", ArgumentType::Path, true}});
+    commandRegistry.add("user stats latency reset", "Reset the keystroke latency histogram", [](const CommandArguments&) {
+        {
+            std::lock_guard<std::mutex> lock(latencyMutex);
+            keystrokeLatency.reset();
+        }
+        std::cout << "Latency histogram reset." << std::endl;
+    });
+    commandRegistry.add("user stats allocations", "Show heap allocations and arena usage per prefix command", [](const CommandArguments&) {
+        std::cout << session->commandArena.getSummary() << std::endl;
+    });
+    commandRegistry.add("user stats allocations reset", "Reset the allocation statistics", [](const CommandArguments&) {
+        session->commandArena.resetStatistics();
+        std::cout << "Allocation statistics reset." << std::endl;
+    });
+
+    addToggleCommands("user saveloop", "Save loop", [] { return session->saveLoop; }, [](bool enabled) { session->saveLoop = enabled; });
+    addToggleCommands("user saveonexit", "Save on exit", [] { return session->saveOnExit; }, [](bool enabled) { session->saveOnExit = enabled; });
+    addToggleCommands("user checkforupdates", "Check for updates", [] { return session->checkForUpdates; }, [](bool enabled) { session->checkForUpdates = enabled; });
+    commandRegistry.add("user update", "Download the latest release if an update is available", [](const CommandArguments&) {
+        std::string latestVersion;
+        std::cout << "Checking for updates..." << std::endl;
+        if (!updateChecker.checkNow(latestVersion)) {
+            std::cerr << "Error: Unable to check for updates or no internet connection." << std::endl;
+            session->lastCommandStatus = 1;
+            return;
+        }
+        if (!UpdateChecker::isNewerVersion(latestVersion, currentVersion)) {
+            std::cout << "You are up to date!." << std::endl;
             return;
         }
-        if (lastCommandParsed == "enable") {
-            checkForUpdates = true;
-            std::cout << "Check for updates enabled." << std::endl;
-            return;
+        std::cout << currentVersion << " -> " << latestVersion << std::endl;
+        if (!downloadLatestRelease()) {
+            std::cout << "Failed to download the update. Please try again later." << std::endl;
+            session->lastCommandStatus = 1;
         }
-        if (lastCommandParsed == "disable") {
-            checkForUpdates = false;
-            std::cout << "Check for updates disabled." << std::endl;
-            return;
+    });
+}
+
+void printStartupCommands() {
+    if (!session->startupCommands.empty()) {
+        std::cout << "Startup commands:" << std::endl;
+        for (const auto& command : session->startupCommands) {
+            std::cout << command << std::endl;
         }
+    } else {
+        std::cout << "No startup commands." << std::endl;
     }
-    if (lastCommandParsed == "help") {
-        std::cout << "Commands: " << std::endl;
-        std::cout << "startup: add [ARGS], remove [ARGS], clear, enable, disable, list, runall" << std::endl;
-        std::cout << "text: commandprefix [ARGS]" << std::endl;
-        std::cout << "shortcut: clear, enable, disable, add [ARGS], remove [ARGS], list" << std::endl;
-        std::cout << "testing [ARGS]" << std::endl;
-        std::cout << "data: get [ARGS], clear" << std::endl;
-        std::cout << "saveloop [ARGS]" << std::endl;
-        std::cout << "saveonexit [ARGS]" << std::endl;
-        std::cout << "checkforupdates [ARGS]" << std::endl;
-        return;
-    }
-    std::cerr << "Unknown command. No given ARGS. Try 'help'" << std::endl;
 }
 
-void userDataCommands(){
-    getNextCommand();
-    if (lastCommandParsed.empty()) {
-        std::cerr << "Error: No arguments provided. Try 'help' for a list of commands." << std::endl;
+void addShortcut(const CommandArguments& arguments, bool templated) {
+    std::string name(arguments.get("SHORTCUT"));
+    ShortcutTemplate shortcutTemplate;
+    std::string error;
+    if (!templated) {
+        shortcutTemplate.compileLiteral(std::string(arguments.get("COMMAND")));
+    } else if (!shortcutTemplate.compile(std::string(arguments.get("COMMAND")), error)) {
+        std::cerr << "Error: " << error << std::endl;
+        session->lastCommandStatus = 1;
         return;
     }
-    if (lastCommandParsed == "get") {
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cerr << "Error: No arguments provided. Try 'help' for a list of commands." << std::endl;
-            return;
-        }
-        if (lastCommandParsed == "userdata") {
-            std::cout << readAndReturnUserDataFile() << std::endl;
-            return;
-        }
-        if (lastCommandParsed == "userhistory") {
-            std::ifstream file(USER_COMMAND_HISTORY);
-            if (file.is_open()) {
-                std::string history((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-                file.close();
-                std::cout << history << std::endl;
-            } else {
-                std::cerr << "Error: Unable to read the user history file at " << USER_COMMAND_HISTORY << std::endl;
-            }
-            return;
-        }
-        if (lastCommandParsed == "all") {
-            std::cout << readAndReturnUserDataFile() << std::endl;
-            std::ifstream file(USER_COMMAND_HISTORY);
-            if (file.is_open()) {
-                std::string history((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-                file.close();
-                std::cout << history << std::endl;
-            } else {
-                std::cerr << "Error: Unable to read the user history file at " << USER_COMMAND_HISTORY << std::endl;
-            }
-            return;
-        }
+    session->shortcuts[name] = arguments.get("COMMAND");
+    session->shortcutTemplates[name] = shortcutTemplate;
+    if (templated) {
+        session->templatedShortcuts.insert(name);
+    } else {
+        session->templatedShortcuts.erase(name);
     }
-    if (lastCommandParsed == "clear") {
-        std::filesystem::remove(USER_DATA);
-        createNewUSER_DATAFile();
-        std::cout << "User data file cleared." << std::endl;
-        std::filesystem::remove(USER_COMMAND_HISTORY);
-        createNewUSER_HISTORYfile();
-        std::cout << "User history file cleared." << std::endl;
+    std::cout << "Shortcut added." << std::endl;
+}
+
+void addMultiScriptShortcut(const CommandArguments& arguments, bool templated) {
+    std::string name(arguments.get("NAME"));
+    std::pmr::vector<std::string_view> commands = arguments.getList("COMMANDS");
+    std::vector<std::string> steps(commands.begin(), commands.end());
+    ShortcutPlan plan;
+    std::string error;
+    if (!plan.compile(steps, templated, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        session->lastCommandStatus = 1;
         return;
     }
-    if(lastCommandParsed == "help") {
-        std::cout << "Commands: " << std::endl;
-        std::cout << "get [ARGS]" << std::endl;
-        std::cout << "clear" << std::endl;
-        return;
+    session->multiScriptShortcuts[name] = steps;
+    session->compiledShortcuts[name] = plan;
+    if (templated) {
+        session->templatedMultiScriptShortcuts.insert(name);
+    } else {
+        session->templatedMultiScriptShortcuts.erase(name);
     }
-    std::cerr << "Error: Unknown command. Try 'help' for a list of commands." << std::endl;
+    std::cout << "Multi-Script Shortcut added." << std::endl;
 }
 
-void startupCommandsHandler() {
-    getNextCommand();
-    if (lastCommandParsed.empty()) {
-        if (!startupCommands.empty()) {
-            std::cout << "Startup commands:" << std::endl;
-            for (const auto& command : startupCommands) {
-                std::cout << command << std::endl;
+void printShortcuts() {
+    if (!session->shortcuts.empty()) {
+        std::cout << "Shortcuts:" << std::endl;
+        for (const auto& [key, value] : session->shortcuts) {
+            std::cout << key + " = " + value << std::endl;
+        }
+    } else {
+        std::cout << "No shortcuts." << std::endl;
+    }
+    if(!session->multiScriptShortcuts.empty()){
+        std::cout << "Multi-Script Shortcuts:" << std::endl;
+        for (const auto& [key, value] : session->multiScriptShortcuts) {
+            std::cout << key + " = ";
+            for(const auto& command : value){
+                std::cout << "'"+command + "' ";
             }
-        } else {
-            std::cout << "No startup commands." << std::endl;
+            std::cout << std::endl;
         }
+    } else {
+        std::cout << "No multi-script shortcuts." << std::endl;
+    }
+}
+
+void printUserHistory(const CommandArguments& arguments) {
+    time_t since = 0;
+    time_t until = std::numeric_limits<time_t>::max();
+    std::string directory;
+    std::string pattern(arguments.get("--grep"));
+    size_t tail = static_cast<size_t>(arguments.getNumber("--tail"));
+    for (const std::string option : {"--since", "--until"}) {
+        if (!arguments.has(option)) {
+            continue;
+        }
+        time_t value;
+        if (!parseTimeArgument(std::string(arguments.get(option)), value)) {
+            std::cerr << "Error: Unrecognized time '" << arguments.get(option) << "'. Use an epoch, YYYY-MM-DD, today, yesterday or an age such as 2h or 3d." << std::endl;
+            session->lastCommandStatus = 1;
+            return;
+        }
+        (option == "--since" ? since : until) = value;
+    }
+    if (arguments.has("--dir")) {
+        std::filesystem::path path = arguments.get("--dir");
+        if (path.is_relative()) {
+            path = std::filesystem::path(session->terminal.getCurrentFilePath()) / path;
+        }
+        directory = path.lexically_normal().string();
+        if (directory.size() > 1 && directory.back() == '/') {
+            directory.pop_back();
+        }
+    }
+    MappedHistory history;
+    if (!history.open(USER_COMMAND_HISTORY)) {
+        std::cerr << "Error: Unable to read the user history file at " << USER_COMMAND_HISTORY << std::endl;
+        session->lastCommandStatus = 1;
         return;
     }
-    if (lastCommandParsed == "add") {
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
-            return;
+    auto matches = [&](const HistoryRecord& entry) {
+        return entry.timestamp >= since && entry.timestamp <= until &&
+            (directory.empty() || MappedHistory::isUnderDirectory(entry.directory, directory)) &&
+            (pattern.empty() || entry.command.find(pattern) != std::string::npos);
+    };
+    HistoryRecord record;
+    size_t first = history.lowerBound(since);
+    size_t last = history.upperBound(until);
+    HistoryArchive archive;
+    std::vector<HistoryArchive::Segment> segments;
+    if (archive.open(HISTORY_ARCHIVE)) {
+        for (const HistoryArchive::Segment& segment : archive.getSegments("history")) {
+            if (segment.lastTimestamp >= since && segment.firstTimestamp <= until) {
+                segments.push_back(segment);
+            }
         }
-        startupCommands.push_back(lastCommandParsed);
-        std::cout << "Command added to startup commands." << std::endl;
-        return;
     }
-    if (lastCommandParsed == "remove") {
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
-            return;
+    std::deque<HistoryRecord> archived;
+    if (tail > 0) {
+        size_t start = last;
+        size_t found = 0;
+        while (start > first && found < tail) {
+            --start;
+            found += history.getRecord(start, record) && matches(record) ? 1 : 0;
+        }
+        first = start;
+        for (auto segment = segments.rbegin(); segment != segments.rend() && found < tail; ++segment) {
+            std::deque<HistoryRecord> newest;
+            archive.forEachRecord(*segment, [&](const HistoryRecord& entry) {
+                if (matches(entry)) {
+                    newest.push_back(entry);
+                    if (newest.size() > tail - found) {
+                        newest.pop_front();
+                    }
+                }
+                return true;
+            });
+            found += newest.size();
+            archived.insert(archived.begin(), newest.begin(), newest.end());
+        }
+        segments.clear();
+    }
+    size_t pageHeight = 0;
+    size_t width = 0;
+    if (isatty(STDOUT_FILENO) && isatty(STDIN_FILENO)) {
+        pageHeight = std::max(getTerminalHeight() - 1, 1);
+        width = std::max(getTerminalWidth(), 1);
+    }
+    std::string buffer;
+    size_t linesOnPage = 0;
+    auto print = [&](const HistoryRecord& entry) {
+        std::string line = formatHistoryRecord(entry);
+        if (pageHeight == 0) {
+            buffer += line + "\n";
+            if (buffer.size() >= 65536) {
+                std::cout << buffer;
+                buffer.clear();
+            }
+            return true;
         }
-        std::vector<std::string> newStartupCommands;
-        bool removed = false;
-        for (const auto& command : startupCommands) {
-            if (command != lastCommandParsed) {
-                newStartupCommands.push_back(command);
-            } else {
-                removed = true;
-                std::cout << "Command removed from startup commands." << std::endl;
+        if (linesOnPage >= pageHeight) {
+            std::cout << buffer;
+            buffer.clear();
+            if (!promptForMoreOutput(linesOnPage, pageHeight)) {
+                return false;
             }
         }
-        if (!removed) {
-            std::cout << "Command not found in startup commands." << std::endl;
+        buffer += line + "\n";
+        linesOnPage += line.empty() ? 1 : (line.size() + width - 1) / width;
+        return true;
+    };
+    for (const HistoryRecord& entry : archived) {
+        if (!print(entry)) {
+            return;
         }
-        startupCommands = newStartupCommands;
-        return;
     }
-    if (lastCommandParsed == "clear") {
-        startupCommands.clear();
-        std::cout << "Startup commands cleared." << std::endl;
-        return;
+    bool stopped = false;
+    for (const HistoryArchive::Segment& segment : segments) {
+        archive.forEachRecord(segment, [&](const HistoryRecord& entry) {
+            stopped = matches(entry) && !print(entry);
+            return !stopped;
+        });
+        if (stopped) {
+            return;
+        }
     }
-    if (lastCommandParsed == "enable") {
-        startCommandsOn = true;
-        std::cout << "Startup commands enabled." << std::endl;
-        return;
+    for (size_t i = first; i < last; i++) {
+        if (history.getRecord(i, record) && matches(record) && !print(record)) {
+            return;
+        }
     }
-    if (lastCommandParsed == "disable") {
-        startCommandsOn = false;
-        std::cout << "Startup commands disabled." << std::endl;
-        return;
+    std::cout << buffer << std::flush;
+}
+
+bool promptForMoreOutput(size_t& linesOnPage, size_t pageHeight) {
+    std::cout << "-- More -- (space: next page, enter: next line, q: quit)" << std::flush;
+    bool wasRaw = rawEnabled;
+    if (!wasRaw) {
+        setRawMode(true);
     }
-    if (lastCommandParsed == "list") {
-        if (!startupCommands.empty()) {
-            std::cout << "Startup commands:" << std::endl;
-            for (const auto& command : startupCommands) {
-                std::cout << command << std::endl;
-            }
-        } else {
-            std::cout << "No startup commands." << std::endl;
-        }
-        return;
+    char c = 0;
+    std::cin.get(c);
+    if (!wasRaw) {
+        setRawMode(false);
     }
-    if (lastCommandParsed == "runall") {
-        if (!startupCommands.empty()) {
-            std::cout << "Running startup commands..." << std::endl;
-            for (const auto& command : startupCommands) {
-                commandParser(commandPrefix + command);
-            }
-        } else {
-            std::cout << "No startup commands." << std::endl;
-        }
-        return;
+    std::cout << "\r\033[2K" << std::flush;
+    if (!std::cin || c == 'q' || c == 'Q') {
+        return false;
     }
-    std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
+    linesOnPage = c == '\n' ? pageHeight - 1 : 0;
+    return true;
 }
 
-void shortcutCommands() {
-    getNextCommand();
-    if (lastCommandParsed.empty()) {
-        if (!shortcuts.empty()) {
-            std::cout << "Shortcuts:" << std::endl;
-            for (const auto& [key, value] : shortcuts) {
-                std::cout << key + " = " + value << std::endl;
-            }
-        } else {
-            std::cout << "No shortcuts." << std::endl;
-        }
-        if(!multiScriptShortcuts.empty()){
-            std::cout << "Multi-Script Shortcuts:" << std::endl;
-            for (const auto& [key, value] : multiScriptShortcuts) {
-                std::cout << key + " = ";
-                for(const auto& command : value){
-                    std::cout << "'"+command + "' ";
-                }
-                std::cout << std::endl;
-            }
-        } else {
-            std::cout << "No multi-script shortcuts." << std::endl;
+std::string formatHistoryRecord(const HistoryRecord& record) {
+    char timeBuffer[32];
+    std::tm local;
+    localtime_r(&record.timestamp, &local);
+    std::strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%d %H:%M:%S", &local);
+    std::string line = timeBuffer;
+    line += " [" + std::to_string(record.exitStatus) + ", " + std::to_string(record.durationMs) + " ms";
+    if (record.count > 1) {
+        line += ", " + std::to_string(record.count) + " runs";
+    }
+    line += "] ";
+    line += (record.directory.empty() ? "-" : record.directory) + ": " + record.command;
+    return line;
+}
+
+bool parseTimeArgument(const std::string& text, time_t& result) {
+    time_t now = time(nullptr);
+    std::tm local;
+    localtime_r(&now, &local);
+    local.tm_hour = 0;
+    local.tm_min = 0;
+    local.tm_sec = 0;
+    if (text == "now") {
+        result = now;
+        return true;
+    }
+    if (text == "today" || text == "yesterday") {
+        local.tm_mday -= text == "yesterday" ? 1 : 0;
+        local.tm_isdst = -1;
+        result = mktime(&local);
+        return true;
+    }
+    if (text.size() == 10 && text[4] == '-' && text[7] == '-') {
+        std::tm date = {};
+        if (sscanf(text.c_str(), "%4d-%2d-%2d", &date.tm_year, &date.tm_mon, &date.tm_mday) != 3) {
+            return false;
         }
-        return;
+        date.tm_year -= 1900;
+        date.tm_mon -= 1;
+        date.tm_isdst = -1;
+        result = mktime(&date);
+        return result != -1;
     }
-    if (lastCommandParsed == "clear") {
-        shortcuts.clear();
-        std::cout << "Shortcuts cleared." << std::endl;
-        return;
+    if (text.empty() || !std::all_of(text.begin(), text.end() - 1, ::isdigit)) {
+        return false;
     }
-    if (lastCommandParsed == "enable") {
-        shotcutsEnabled = true;
-        std::cout << "Shortcuts enabled." << std::endl;
-        return;
+    bool absolute = std::isdigit(static_cast<unsigned char>(text.back()));
+    const char* digitsEnd = text.data() + text.size() - (absolute ? 0 : 1);
+    time_t value = 0;
+    auto [end, error] = std::from_chars(text.data(), digitsEnd, value);
+    if (error != std::errc() || end != digitsEnd) {
+        return false;
     }
-    if (lastCommandParsed == "disable") {
-        shotcutsEnabled = false;
-        std::cout << "Shortcuts disabled." << std::endl;
-        return;
+    if (absolute) {
+        result = value;
+        return true;
+    }
+    static const std::map<char, time_t> units = {{'s', 1}, {'m', 60}, {'h', 3600}, {'d', 86400}, {'w', 604800}};
+    auto unit = units.find(text.back());
+    if (unit == units.end() || value > std::numeric_limits<time_t>::max() / unit->second) {
+        return false;
     }
-    if(lastCommandParsed == "mm"){
-        multiScriptShortcutCommands();
+    result = now - value * unit->second;
+    return true;
+}
+
+void archiveChatLogs() {
+    std::vector<std::pair<time_t, std::filesystem::path>> logs;
+    uintmax_t totalBytes = 0;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(DATA_DIRECTORY, ec)) {
+        std::string name = entry.path().filename().string();
+        if (!isChatLogName(name)) {
+            continue;
+        }
+        logs.push_back({static_cast<time_t>(std::strtoll(name.c_str() + 13, nullptr, 10)), entry.path()});
+        totalBytes += entry.file_size(ec);
+    }
+    if (logs.size() < 2) {
         return;
     }
-    if (lastCommandParsed == "add") {
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
-            return;
-        }
-        std::string shortcut = lastCommandParsed;
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
-            return;
+    std::sort(logs.begin(), logs.end());
+    size_t count = 0;
+    if (totalBytes > CHAT_LOG_ARCHIVE_BYTES) {
+        count = logs.size() - 1;
+    } else {
+        time_t cutoff = time(nullptr) - CHAT_LOG_ARCHIVE_AGE;
+        while (count < logs.size() - 1 && logs[count].first < cutoff) {
+            count++;
         }
-        std::string command = lastCommandParsed;
-        shortcuts[shortcut] = command;
-        std::cout << "Shortcut added." << std::endl;
+    }
+    if (count == 0) {
         return;
     }
-    if (lastCommandParsed == "remove") {
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
-            return;
-        }
-        if(shortcuts.find(lastCommandParsed) == shortcuts.end()){
-            std::cout << "Shortcut not found." << std::endl;
-            return;
-        }
-        shortcuts.erase(lastCommandParsed);
-        std::cout << "Shortcut removed." << std::endl;
+    std::string data;
+    for (size_t i = 0; i < count; i++) {
+        std::ifstream file(logs[i].second, std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        data += HistoryArchive::encodeFile(logs[i].second.filename().string(), content);
+    }
+    HistoryArchive archive;
+    HistoryArchive::Segment segment;
+    archive.open(HISTORY_ARCHIVE);
+    if (!archive.writeSegment("chat", data, logs.front().first, logs[count - 1].first, count, segment)) {
+        std::cerr << "Error: Unable to archive chat logs in " << HISTORY_ARCHIVE << std::endl;
+        session->lastCommandStatus = 1;
         return;
     }
-    if (lastCommandParsed == "list") {
-        if (!shortcuts.empty()) {
-            std::cout << "Shortcuts:" << std::endl;
-            for (const auto& [key, value] : shortcuts) {
-                std::cout << key + " = " + value << std::endl;
-            }
-        } else {
-            std::cout << "No shortcuts." << std::endl;
-        }
-        if(!multiScriptShortcuts.empty()){
-            std::cout << "Multi-Script Shortcuts:" << std::endl;
-            for (const auto& [key, value] : multiScriptShortcuts) {
-                std::cout << key + " = ";
-                for(const auto& command : value){
-                    std::cout << "'"+command + "' ";
-                }
-                std::cout << std::endl;
-            }
-        } else {
-            std::cout << "No multi-script shortcuts." << std::endl;
-        }
+    if (!archive.commitSegment(segment)) {
+        archive.discardSegment(segment);
+        std::cerr << "Error: Unable to archive chat logs in " << HISTORY_ARCHIVE << std::endl;
+        session->lastCommandStatus = 1;
         return;
     }
-    std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
+    for (size_t i = 0; i < count; i++) {
+        std::filesystem::remove(logs[i].second, ec);
+    }
 }
 
-void multiScriptShortcutCommands(){
-    getNextCommand();
-    if (lastCommandParsed.empty()) {
-        std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
-        return;
-    }
-    if(lastCommandParsed == "add"){
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
-            return;
-        }
-        std::string shortcut = lastCommandParsed;
-        std::vector<std::string> commands;
-        getNextCommand();
-        while(!lastCommandParsed.empty()){
-            commands.push_back(lastCommandParsed);
-            getNextCommand();
+void listChatLogs() {
+    HistoryArchive archive;
+    if (archive.open(HISTORY_ARCHIVE)) {
+        for (const HistoryArchive::Segment& segment : archive.getSegments("chat")) {
+            archive.forEachFile(segment, [](const std::string& name, const std::string&) {
+                std::cout << name << " (archived)" << std::endl;
+                return true;
+            });
         }
-        if(commands.empty()){
-            std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
-            return;
+    }
+    std::vector<std::string> names;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(DATA_DIRECTORY, ec)) {
+        std::string name = entry.path().filename().string();
+        if (isChatLogName(name)) {
+            names.push_back(name);
         }
-        multiScriptShortcuts[shortcut] = commands;
-        std::cout << "Multi-Script Shortcut added." << std::endl;
-        return;
     }
-    if(lastCommandParsed == "remove"){
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
+    std::sort(names.begin(), names.end());
+    for (const std::string& name : names) {
+        std::cout << name << std::endl;
+    }
+}
+
+void showChatLog(const std::string& name) {
+    if (name == std::filesystem::path(name).filename() && isChatLogName(name)) {
+        std::ifstream file(DATA_DIRECTORY / name);
+        if (file.is_open()) {
+            std::cout << file.rdbuf() << std::flush;
             return;
         }
-        if(multiScriptShortcuts.find(lastCommandParsed) == multiScriptShortcuts.end()){
-            std::cout << "Multi-Script Shortcut not found." << std::endl;
-            return;
+    }
+    bool found = false;
+    HistoryArchive archive;
+    if (archive.open(HISTORY_ARCHIVE)) {
+        for (const HistoryArchive::Segment& segment : archive.getSegments("chat")) {
+            archive.forEachFile(segment, [&](const std::string& archivedName, const std::string& content) {
+                found = archivedName == name;
+                if (found) {
+                    std::cout << content << std::flush;
+                }
+                return !found;
+            });
+            if (found) {
+                return;
+            }
         }
-        multiScriptShortcuts.erase(lastCommandParsed);
-        std::cout << "Multi-Script Shortcut removed." << std::endl;
-        return;
     }
-    std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
+    std::cerr << "Error: No chat log named " << name << std::endl;
+    session->lastCommandStatus = 1;
 }
 
-void textCommands() {
-    getNextCommand();
-    if (lastCommandParsed.empty()) {
-        std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
-        return;
-    }
-    if (lastCommandParsed == "commandprefix") {
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "Command prefix is currently " + commandPrefix << std::endl;
-            return;
+bool isChatLogName(const std::string& name) {
+    return name.rfind("OpenAPI_Chat_", 0) == 0 && std::filesystem::path(name).extension() == ".txt";
+}
+
+void registerUserDataCommands() {
+    using ArgumentType = CommandRegistry::ArgumentType;
+    const std::vector<CommandRegistry::Argument> historyOptions = {
+        {"--since"}, {"--until"}, {"--dir", ArgumentType::Path}, {"--grep"}, {"--tail", ArgumentType::Number}
+    };
+    commandRegistry.describe("user data", "View, migrate, compact and clear user data");
+    commandRegistry.describe("user data get", "View user data");
+    commandRegistry.add("user data get userdata", "View user settings data", [](const CommandArguments&) {
+        std::cout << readAndReturnUserDataFile() << std::endl;
+    });
+    commandRegistry.add("user data get userhistory", "View command history", [](const CommandArguments& arguments) {
+        printUserHistory(arguments);
+    }, historyOptions);
+    commandRegistry.add("user data get all", "View all user data", [](const CommandArguments& arguments) {
+        std::cout << readAndReturnUserDataFile() << std::endl;
+        printUserHistory(arguments);
+    }, historyOptions);
+    commandRegistry.add("user data historysync", "Show how often history is flushed to disk", [](const CommandArguments&) {
+        std::lock_guard<std::mutex> lock(historyMutex);
+        if (historyWriter.getSyncPolicy() == HistoryWriter::SyncPolicy::EveryCommands) {
+            std::cout << "History is synced to disk every " << historyWriter.getSyncValue() << " commands." << std::endl;
+        } else if (historyWriter.getSyncPolicy() == HistoryWriter::SyncPolicy::Interval) {
+            std::cout << "History is synced to disk at most every " << historyWriter.getSyncValue() << " ms." << std::endl;
+        } else {
+            std::cout << "History is synced to disk on exit." << std::endl;
         }
-        if (lastCommandParsed.length() > 1) {
-            std::cout << "Invalid command prefix. Must be a single character." << std::endl;
-            return;
-        } else if (lastCommandParsed == " ") {
-            std::cout << "Invalid command prefix. Must not be a space." << std::endl;
+    });
+    auto setSyncPolicy = [](HistoryWriter::SyncPolicy policy, uint64_t value) {
+        if (policy == HistoryWriter::SyncPolicy::EveryCommands && value == 0) {
+            std::cerr << "Error: The command count must be at least 1." << std::endl;
+            session->lastCommandStatus = 1;
             return;
         }
-        commandPrefix = lastCommandParsed;
-        std::cout << "Command prefix set to " + commandPrefix << std::endl;
-        return;
-    }
-    if(lastCommandParsed == "displayfullpath"){
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "Display whole path is currently " << (terminal.isDisplayWholePath() ? "enabled." : "disabled.") << std::endl;
-            return;
+        {
+            std::lock_guard<std::mutex> lock(historyMutex);
+            historyWriter.setSyncPolicy(policy, value);
         }
-        if(lastCommandParsed == "enable"){
-            terminal.setDisplayWholePath(true);
-            std::cout << "Display whole path enabled." << std::endl;
-            return;
+        writeUserData();
+        std::cout << "History sync policy set to " << HistoryWriter::getPolicyName(policy) << (policy == HistoryWriter::SyncPolicy::OnExit ? "" : " " + std::to_string(value)) << "." << std::endl;
+    };
+    commandRegistry.add("user data historysync commands", "Flush history to disk every N commands", [setSyncPolicy](const CommandArguments& arguments) {
+        setSyncPolicy(HistoryWriter::SyncPolicy::EveryCommands, arguments.getNumber("N"));
+    }, {{"N", ArgumentType::Number}});
+    commandRegistry.add("user data historysync interval", "Flush history to disk at most every MS milliseconds", [setSyncPolicy](const CommandArguments& arguments) {
+        setSyncPolicy(HistoryWriter::SyncPolicy::Interval, arguments.getNumber("MS"));
+    }, {{"MS", ArgumentType::Number}});
+    commandRegistry.add("user data historysync exit", "Flush history to disk only on exit", [setSyncPolicy](const CommandArguments&) {
+        setSyncPolicy(HistoryWriter::SyncPolicy::OnExit, 0);
+    });
+    commandRegistry.add("user data historylimit", "Show how much history is kept", [](const CommandArguments&) {
+        std::cout << "History keeps at most " << historyCompactor.getMaxEntries() << " unique entries";
+        if (historyCompactor.getMaxAgeDays() > 0) {
+            std::cout << " from the last " << historyCompactor.getMaxAgeDays() << " days";
+        }
+        std::cout << "." << std::endl;
+    });
+    auto setHistoryLimit = [](const std::string& limit, uint64_t value) {
+        if (limit == "entries") {
+            historyCompactor.setLimits(static_cast<size_t>(value), historyCompactor.getMaxAgeDays());
+        } else {
+            historyCompactor.setLimits(historyCompactor.getMaxEntries(), static_cast<uint32_t>(value));
         }
-        if(lastCommandParsed == "disable"){
-            terminal.setDisplayWholePath(false);
-            std::cout << "Display whole path disabled." << std::endl;
-            return;
+        writeUserData();
+        std::cout << "History " << limit << " limit set to " << (value == 0 ? "unlimited" : std::to_string(value)) << "." << std::endl;
+    };
+    commandRegistry.add("user data historylimit entries", "Keep at most N unique history entries (0 for unlimited)", [setHistoryLimit](const CommandArguments& arguments) {
+        setHistoryLimit("entries", arguments.getNumber("N"));
+    }, {{"N", ArgumentType::Number}});
+    commandRegistry.add("user data historylimit age", "Drop history entries older than DAYS (0 for unlimited)", [setHistoryLimit](const CommandArguments& arguments) {
+        setHistoryLimit("age", arguments.getNumber("DAYS"));
+    }, {{"DAYS", ArgumentType::Number}});
+    commandRegistry.add("user data compacthistory", "Deduplicate and trim the history file now", [](const CommandArguments&) {
+        HistoryCompactor::Result result;
+        if (!historyCompactor.compactNow(result)) {
+            std::cerr << "Error: Unable to compact the user history file at " << USER_COMMAND_HISTORY << std::endl;
+            session->lastCommandStatus = 1;
+            return;
+        }
+        if (!result.rewritten) {
+            std::cout << "History is already compact (" << result.recordsAfter << " entries)." << std::endl;
+            return;
+        }
+        session->terminal.loadPersistedHistory(USER_COMMAND_HISTORY);
+        std::cout << "Compacted history from " << result.recordsBefore << " to " << result.recordsAfter << " entries ("
+                  << result.bytesBefore << " to " << result.bytesAfter << " bytes)";
+        if (result.archived > 0) {
+            std::cout << ", archived " << result.archived << " older entries";
+        }
+        std::cout << "." << std::endl;
+    });
+    commandRegistry.add("user data archive", "Show archived history and chat log segments", [](const CommandArguments&) {
+        HistoryArchive archive;
+        archive.open(HISTORY_ARCHIVE);
+        for (const std::string kind : {"history", "chat"}) {
+            std::vector<HistoryArchive::Segment> segments = archive.getSegments(kind);
+            size_t entries = 0;
+            uint64_t rawBytes = 0;
+            uint64_t compressedBytes = 0;
+            for (const HistoryArchive::Segment& segment : segments) {
+                entries += segment.entries;
+                rawBytes += segment.rawBytes;
+                compressedBytes += archive.getSegmentSize(segment);
+            }
+            std::cout << kind << ": " << segments.size() << " segments, " << entries << " entries, "
+                      << rawBytes << " bytes compressed to " << compressedBytes << " bytes" << std::endl;
         }
-    }
-    if(lastCommandParsed == "defaultentry"){
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "Default text entry is currently " << (defaultTextEntryOnAI ? "AI." : "terminal.") << std::endl;
+    });
+    commandRegistry.add("user data migratehistory", "Import a text history file into the binary history", [](const CommandArguments& arguments) {
+        std::filesystem::path textFile = arguments.has("FILE") ? std::filesystem::path(arguments.get("FILE")) : LEGACY_USER_COMMAND_HISTORY;
+        if (!std::filesystem::exists(textFile)) {
+            std::cerr << "Error: No text history found at " << textFile << std::endl;
+            session->lastCommandStatus = 1;
             return;
         }
-        if(lastCommandParsed == "ai"){
-            defaultTextEntryOnAI = true;
-            std::cout << "Default text entry set to AI." << std::endl;
-            return;
+        {
+            std::lock_guard<std::mutex> lock(historyMutex);
+            historyWriter.close();
         }
-        if(lastCommandParsed == "terminal"){
-            defaultTextEntryOnAI = false;
-            std::cout << "Default text entry set to terminal." << std::endl;
+        size_t migrated = 0;
+        if (!MappedHistory::migrateTextHistory(textFile, USER_COMMAND_HISTORY, migrated)) {
+            std::cerr << "Error: Unable to migrate " << textFile << std::endl;
+            session->lastCommandStatus = 1;
             return;
         }
-    }
-    std::cout << "Unknown command. No given ARGS. Try 'help'" << std::endl;
-}
-
-void getNextCommand() {
-    if (!commandsQueue.empty()) {
-        lastCommandParsed = commandsQueue.front();
-        commandsQueue.pop();
-        if (TESTING) {
-            std::cout << "Processed Command: " << lastCommandParsed << std::endl;
+        if (textFile == LEGACY_USER_COMMAND_HISTORY) {
+            std::filesystem::rename(textFile, textFile.string() + ".migrated");
         }
-    } else {
-        lastCommandParsed = "";
-    }
+        session->terminal.loadPersistedHistory(USER_COMMAND_HISTORY);
+        std::cout << "Migrated " << migrated << " history entries into " << USER_COMMAND_HISTORY << std::endl;
+    }, {{"FILE", ArgumentType::Path, true}});
+    commandRegistry.add("user data clear", "Clear all user data", [](const CommandArguments&) {
+        std::filesystem::remove(USER_DATA);
+        createNewUSER_DATAFile();
+        std::cout << "User data file cleared." << std::endl;
+        std::filesystem::remove(USER_COMMAND_HISTORY);
+        std::filesystem::remove(MappedHistory::getIndexPath(USER_COMMAND_HISTORY));
+        HistoryArchive archive;
+        if (archive.open(HISTORY_ARCHIVE)) {
+            archive.removeSegments("history");
+        }
+        createNewUSER_HISTORYfile();
+        session->terminal.loadPersistedHistory(USER_COMMAND_HISTORY);
+        std::cout << "User history file cleared." << std::endl;
+    });
 }
 
-void aiSettingsCommands() {
-    getNextCommand();
-    if (lastCommandParsed.empty()) {
-        defaultTextEntryOnAI = true;
+void registerAiCommands() {
+    using ArgumentType = CommandRegistry::ArgumentType;
+    commandRegistry.add("ai", "Switch text entry to the AI and show the chat history", [](const CommandArguments&) {
+        session->defaultTextEntryOnAI = true;
         showChatHistory();
-        return;
-    }
-    if (lastCommandParsed == "log") {
-        std::string lastChatSent = openAIPromptEngine.getLastPromptUsed();
-        std::string lastChatReceived = openAIPromptEngine.getLastResponseReceived();
+    });
+    commandRegistry.add("ai log", "Log the last AI conversation to a file", [](const CommandArguments&) {
+        std::string lastChatSent = session->getPromptEngine().getLastPromptUsed();
+        std::string lastChatReceived = session->getPromptEngine().getLastResponseReceived();
         std::string fileName = (DATA_DIRECTORY / ("OpenAPI_Chat_" + std::to_string(time(nullptr)) + ".txt")).string();
         std::ofstream file(fileName);
         if (file.is_open()) {
@@ -1152,261 +2323,165 @@ void aiSettingsCommands() {
             std::cout << "Chat log saved to " << fileName << std::endl;
         } else {
             std::cerr << "Error: Unable to create the chat log file at " << fileName << std::endl;
-            return;
-        }
-    }
-    if (lastCommandParsed == "apikey") {
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << openAIPromptEngine.getAPIKey() << std::endl;
-            return;
-        }
-        if (lastCommandParsed == "set") {
-            getNextCommand();
-            if (lastCommandParsed.empty()) {
-                std::cerr << "Error: No API key provided. Try 'help' for a list of commands." << std::endl;
-                return;
-            }
-            openAIPromptEngine.setAPIKey(lastCommandParsed);
-            if (openAIPromptEngine.testAPIKey(openAIPromptEngine.getAPIKey())) {
-                std::cout << "OpenAI API key set successfully." << std::endl;
-                return;
-            } else {
-                std::cerr << "Error: Invalid API key." << std::endl;
-                return;
-            }
-        }
-        if (lastCommandParsed == "get") {
-            std::cout << openAIPromptEngine.getAPIKey() << std::endl;
-            return;
-        }
-        std::cerr << "Error: Unknown command. Try 'help' for a list of commands." << std::endl;
-        return;
-    }
-    if (lastCommandParsed == "chat") {
-        aiChatCommands();
-        return;
-    }
-    if (lastCommandParsed == "get") {
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cerr << "Error: No arguments provided. Try 'help' for a list of commands." << std::endl;
-            return;
-        }
-        std::cout << openAIPromptEngine.getResponseData(lastCommandParsed) << std::endl;
-        return;
-    }
-    if (lastCommandParsed == "dump") {
-        std::cout << openAIPromptEngine.getResponseData("all") << std::endl;
-        std::cout << openAIPromptEngine.getLastPromptUsed() << std::endl;
-        return;
-    }
-    if (lastCommandParsed == "mode") {
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "The current assistant mode is " << openAIPromptEngine.getAssistantType() << std::endl;
-            return;
-        }
-        openAIPromptEngine.setAssistantType(lastCommandParsed);
-        std::cout << "Assistant mode set to " << lastCommandParsed << std::endl;
-        return;
-    }
-    if (lastCommandParsed == "file") {
-        getNextCommand();
-        std::vector<std::string> filesAtPath = terminal.getFilesAtCurrentPath();
-        if (lastCommandParsed.empty()) {
-            std::vector<std::string> activeFiles = openAIPromptEngine.getFiles();
-            std::cout << "Active Files: " << std::endl;
-            for(const auto& file : activeFiles){
-                std::cout << file << std::endl;
-            }
-            std::cout << "Total characters processed: " << openAIPromptEngine.getFileContents().length() << std::endl;
-            std::cout << "Files at current path: " << std::endl;
-            for(const auto& file : filesAtPath){
-                std::cout << file << std::endl;
-            }
-            return;
-        }
-        if (lastCommandParsed == "add"){
-            getNextCommand();
-            if (lastCommandParsed.empty()) {
-                std::cerr << "Error: No file specified. Try 'help' for a list of commands." << std::endl;
-                return;
-            }
-            if (lastCommandParsed == "all"){
-                std::cout << "Processed " << openAIPromptEngine.addFiles(filesAtPath) <<  " characters."  << std::endl;
-                return;
-            }
-            std::string fileToAdd = terminal.getFullPathOfFile(lastCommandParsed);
-            if(fileToAdd.empty()){
-                std::cerr << "Error: File not found." << std::endl;
-                return;
-            }
-            std::cout << "Processed "<<openAIPromptEngine.addFile(fileToAdd) << " characters." << std::endl;
-            return;
-        }
-        if (lastCommandParsed == "remove"){
-            getNextCommand();
-            if (lastCommandParsed.empty()) {
-                std::cerr << "Error: No file specified. Try 'help' for a list of commands." << std::endl;
-                return;
-            }
-            if (lastCommandParsed == "all"){
-                openAIPromptEngine.clearFiles();
-                return;
-            }
-            std::string fileToRemove = terminal.getFullPathOfFile(lastCommandParsed);
-            if(fileToRemove.empty()){
-                std::cerr << "Error: File not found." << std::endl;
-                return;
-            }
-            openAIPromptEngine.removeFile(fileToRemove);
-            return;
-        }
-        if (lastCommandParsed == "active"){
-            std::vector<std::string> activeFiles = openAIPromptEngine.getFiles();
-            std::cout << "Active Files: " << std::endl;
-            for(const auto& file : activeFiles){
-                std::cout << file << std::endl;
-            }
-            std::cout << "Total characters processed: " << openAIPromptEngine.getFileContents().length() << std::endl;
-            return;
-        }
-        if (lastCommandParsed == "available"){
-            std::cout << "Files at current path: " << std::endl;
-            for(const auto& file : filesAtPath){
-                std::cout << file << std::endl;
-            }
-            return;
-        }
-        if(lastCommandParsed == "refresh"){
-            openAIPromptEngine.refreshFiles();
-            std::cout << "Files refreshed." << std::endl;
-            return;
-        }
-        if(lastCommandParsed == "clear"){
-            openAIPromptEngine.clearFiles();
-            std::cout << "Files cleared." << std::endl;
-            return;
-        }
-        std::cerr << "Error: Unknown command. Try 'help' for a list of commands." << std::endl;
-        return;
-    }
-    if(lastCommandParsed == "directory"){
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "The current directory is " << openAIPromptEngine.getSaveDirectory() << std::endl;
-            return;
-        }
-        if(lastCommandParsed == "set") {
-            openAIPromptEngine.setSaveDirectory(terminal.getCurrentFilePath());
-            std::cout << "Directory set to " << terminal.getCurrentFilePath() << std::endl;
-            return;
-        }
-        if(lastCommandParsed == "clear") {
-            openAIPromptEngine.setSaveDirectory(".DTT-Data");
-            std::cout << "Directory set to default." << std::endl;
-            return;
-        }
-    }
-    if(lastCommandParsed == "model"){
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "The current model is " << openAIPromptEngine.getModel() << std::endl;
-            return;
-        }
-        openAIPromptEngine.setModel(lastCommandParsed);
-        std::cout << "Model set to " << lastCommandParsed << std::endl;
-        return;
-    }
-    if(lastCommandParsed == "rejectchanges"){
-        openAIPromptEngine.rejectChanges();
+            session->lastCommandStatus = 1;
+            return;
+        }
+        archiveChatLogs();
+    });
+    commandRegistry.add("ai log list", "List saved chat logs, including archived ones", [](const CommandArguments&) {
+        listChatLogs();
+    });
+    commandRegistry.add("ai log show", "Print a saved or archived chat log", [](const CommandArguments& arguments) {
+        showChatLog(std::string(arguments.get("NAME")));
+    }, {{"NAME"}});
+    commandRegistry.add("ai apikey", "Display the current API key", [](const CommandArguments&) {
+        std::cout << session->getPromptEngine().getAPIKey() << std::endl;
+    });
+    commandRegistry.add("ai apikey set", "Set the OpenAI API key", [](const CommandArguments& arguments) {
+        session->getPromptEngine().setAPIKey(std::string(arguments.get("KEY")));
+        if (session->getPromptEngine().testAPIKey(session->getPromptEngine().getAPIKey())) {
+            std::cout << "OpenAI API key set successfully." << std::endl;
+        } else {
+            std::cerr << "Error: Invalid API key." << std::endl;
+            session->lastCommandStatus = 1;
+        }
+    }, {{"KEY"}});
+    commandRegistry.add("ai apikey get", "Display the current API key", [](const CommandArguments&) {
+        std::cout << session->getPromptEngine().getAPIKey() << std::endl;
+    });
+    commandRegistry.add("ai chat", "Send a message to ChatGPT", [](const CommandArguments& arguments) {
+        std::string message(arguments.get("MESSAGE"));
+        std::cout << "Sent message to GPT: " << message << std::endl;
+        chatProcess(message);
+    }, {{"MESSAGE", ArgumentType::Line}});
+    commandRegistry.describe("ai chat history", "Manage the chat history");
+    commandRegistry.add("ai chat history clear", "Clear the chat history", [](const CommandArguments&) {
+        session->getPromptEngine().clearChatCache();
+        session->savedChatCache.clear();
+        session->getPromptEngine().clearAllCachedTokens();
+        std::cout << "Chat history cleared." << std::endl;
+    });
+    addToggleCommands("ai chat cache", "Cache tokens",
+        [] { return session->getPromptEngine().getCacheTokens(); }, [](bool enabled) { session->getPromptEngine().setCacheTokens(enabled); });
+    commandRegistry.add("ai chat cache clear", "Clear cached tokens", [](const CommandArguments&) {
+        session->getPromptEngine().clearAllCachedTokens();
+        std::cout << "Chat history cleared." << std::endl;
+    });
+    commandRegistry.add("ai get", "Get specific response data", [](const CommandArguments& arguments) {
+        std::cout << session->getPromptEngine().getResponseData(std::string(arguments.get("KEY"))) << std::endl;
+    }, {{"KEY"}});
+    commandRegistry.add("ai dump", "Dump the complete response data", [](const CommandArguments&) {
+        std::cout << session->getPromptEngine().getResponseData("all") << std::endl;
+        std::cout << session->getPromptEngine().getLastPromptUsed() << std::endl;
+    });
+    commandRegistry.add("ai mode", "Show or set the assistant type", [](const CommandArguments& arguments) {
+        if (!arguments.has("MODE")) {
+            std::cout << "The current assistant mode is " << session->getPromptEngine().getAssistantType() << std::endl;
+            return;
+        }
+        session->getPromptEngine().setAssistantType(std::string(arguments.get("MODE")));
+        std::cout << "Assistant mode set to " << arguments.get("MODE") << std::endl;
+    }, {{"MODE", ArgumentType::Text, true, [] { return std::vector<std::string>{"chat", "file-search", "code-interpreter"}; }}});
+    commandRegistry.add("ai file", "List active files and files at the current path", [](const CommandArguments&) {
+        printActiveFiles();
+        printAvailableFiles();
+    });
+    commandRegistry.add("ai file add", "Add a file, or all files in the directory, to the AI context", [](const CommandArguments& arguments) {
+        std::string fileName(arguments.get("FILE"));
+        if (fileName.empty() && isatty(STDIN_FILENO)) {
+            fileName = runFuzzyPicker(session->terminal.getFilesUnderCurrentPath(500000), "file");
+        }
+        if (fileName.empty()) {
+            std::cerr << "Error: No file specified. Try 'help' for a list of commands." << std::endl;
+            session->lastCommandStatus = 1;
+            return;
+        }
+        if (fileName == "all"){
+            std::cout << "Processed " << session->getPromptEngine().addFiles(session->terminal.getFilesAtCurrentPath()) <<  " characters."  << std::endl;
+            return;
+        }
+        std::string fileToAdd = session->terminal.getFullPathOfFile(fileName);
+        if(fileToAdd.empty()){
+            std::cerr << "Error: File not found." << std::endl;
+            session->lastCommandStatus = 1;
+            return;
+        }
+        std::cout << "Processed "<<session->getPromptEngine().addFile(fileToAdd) << " characters." << std::endl;
+    }, {{"FILE", ArgumentType::Path, true}});
+    commandRegistry.add("ai file remove", "Remove a file, or all files, from the AI context", [](const CommandArguments& arguments) {
+        if (arguments.get("FILE") == "all"){
+            session->getPromptEngine().clearFiles();
+            return;
+        }
+        std::string fileToRemove = session->terminal.getFullPathOfFile(std::string(arguments.get("FILE")));
+        if(fileToRemove.empty()){
+            std::cerr << "Error: File not found." << std::endl;
+            session->lastCommandStatus = 1;
+            return;
+        }
+        session->getPromptEngine().removeFile(fileToRemove);
+    }, {{"FILE", ArgumentType::Path}});
+    commandRegistry.add("ai file active", "List active files in the AI context", [](const CommandArguments&) {
+        printActiveFiles();
+    });
+    commandRegistry.add("ai file available", "List files available in the current directory", [](const CommandArguments&) {
+        printAvailableFiles();
+    });
+    commandRegistry.add("ai file refresh", "Refresh active file contents", [](const CommandArguments&) {
+        session->getPromptEngine().refreshFiles();
+        std::cout << "Files refreshed." << std::endl;
+    });
+    commandRegistry.add("ai file clear", "Clear all files from the AI context", [](const CommandArguments&) {
+        session->getPromptEngine().clearFiles();
+        std::cout << "Files cleared." << std::endl;
+    });
+    commandRegistry.add("ai directory", "Show where AI-generated files are saved", [](const CommandArguments&) {
+        std::cout << "The current directory is " << session->getPromptEngine().getSaveDirectory() << std::endl;
+    });
+    commandRegistry.add("ai directory set", "Save AI-generated files in the current directory", [](const CommandArguments&) {
+        session->getPromptEngine().setSaveDirectory(session->terminal.getCurrentFilePath());
+        std::cout << "Directory set to " << session->terminal.getCurrentFilePath() << std::endl;
+    });
+    commandRegistry.add("ai directory clear", "Save AI-generated files in the default directory", [](const CommandArguments&) {
+        session->getPromptEngine().setSaveDirectory(".DTT-Data");
+        std::cout << "Directory set to default." << std::endl;
+    });
+    commandRegistry.add("ai model", "Show or set the AI model", [](const CommandArguments& arguments) {
+        if (!arguments.has("MODEL")) {
+            std::cout << "The current model is " << session->getPromptEngine().getModel() << std::endl;
+            return;
+        }
+        session->getPromptEngine().setModel(std::string(arguments.get("MODEL")));
+        std::cout << "Model set to " << arguments.get("MODEL") << std::endl;
+    }, {{"MODEL", ArgumentType::Text, true}});
+    commandRegistry.add("ai rejectchanges", "Reject AI-suggested changes", [](const CommandArguments&) {
+        session->getPromptEngine().rejectChanges();
         std::cout << "Changes rejected." << std::endl;
-        return;
-    }
-    if(lastCommandParsed == "timeoutflag"){
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cout << "The current timeout flag is " << openAIPromptEngine.getTimeoutFlagSeconds() << std::endl;
+    });
+    commandRegistry.add("ai timeoutflag", "Show or set the timeout for AI responses", [](const CommandArguments& arguments) {
+        if (!arguments.has("SECONDS")) {
+            std::cout << "The current timeout flag is " << session->getPromptEngine().getTimeoutFlagSeconds() << std::endl;
             return;
         }
-        openAIPromptEngine.setTimeoutFlagSeconds(std::stoi(lastCommandParsed));
-        std::cout << "Timeout flag set to " << lastCommandParsed << " seconds."<< std::endl;
-        return;
-    }
-    if (lastCommandParsed == "help") {
-        std::cout << "Commands: " << std::endl;
-        std::cout << "log" << std::endl;
-        std::cout << "apikey: set [ARGS], get" << std::endl;
-        std::cout << "chat: [ARGS]" << std::endl;
-        std::cout << "get: [ARGS]" << std::endl;
-        std::cout << "dump" << std::endl;
-        std::cout << "mode: [ARGS]" << std::endl;
-        std::cout << "file: add [ARGS], remove [ARGS], active, available, refresh" << std::endl;
-        std::cout << "directory: set, clear" << std::endl;
-        std::cout << "model: [ARGS]" << std::endl;
-        std::cout << "rejectchanges" << std::endl;
-        std::cout << "timeoutflag: [ARGS]" << std::endl;
-        return;
-    }
-    std::cerr << "Error: Unknown command. Try 'help' for a list of commands." << std::endl;
+        session->getPromptEngine().setTimeoutFlagSeconds(static_cast<float>(arguments.getNumber("SECONDS")));
+        std::cout << "Timeout flag set to " << arguments.get("SECONDS") << " seconds."<< std::endl;
+    }, {{"SECONDS", ArgumentType::Number, true}});
 }
 
-void aiChatCommands() {
-    getNextCommand();
-    if (lastCommandParsed.empty()) {
-        std::cerr << "Error: No arguments provided. Try 'help' for a list of commands." << std::endl;
-        return;
+void printActiveFiles() {
+    std::vector<std::string> activeFiles = session->getPromptEngine().getFiles();
+    std::cout << "Active Files: " << std::endl;
+    for(const auto& file : activeFiles){
+        std::cout << file << std::endl;
     }
-    if (lastCommandParsed == "history") {
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cerr << "Error: No arguments provided. Try 'help' for a list of commands." << std::endl;
-            return;
-        }
-        if (lastCommandParsed == "clear") {
-            openAIPromptEngine.clearChatCache();
-            savedChatCache.clear();
-            openAIPromptEngine.clearAllCachedTokens();
-            std::cout << "Chat history cleared." << std::endl;
-            return;
-        }
-    }
-    if (lastCommandParsed == "cache") {
-        getNextCommand();
-        if (lastCommandParsed.empty()) {
-            std::cerr << "Error: No arguments provided. Try 'help' for a list of commands." << std::endl;
-            return;
-        }
-        if (lastCommandParsed == "enable") {
-            openAIPromptEngine.setCacheTokens(true);
-            std::cout << "Cache tokens enabled." << std::endl;
-            return;
-        }
-        if (lastCommandParsed == "disable") {
-            openAIPromptEngine.setCacheTokens(false);
-            std::cout << "Cache tokens disabled." << std::endl;
-            return;
-        }
-        if (lastCommandParsed == "clear") {
-            openAIPromptEngine.clearAllCachedTokens();
-            std::cout << "Chat history cleared." << std::endl;
-            return;
-        }
-    }
-    if (lastCommandParsed == "help") {
-        std::cout << "Commands: " << std::endl;
-        std::cout << "history: clear" << std::endl;
-        std::cout << "cache: enable, disable, clear" << std::endl;
-        return;
-    }
-    for(int i = 0; i < commandsQueue.size(); i++){
-        lastCommandParsed += " " + commandsQueue.front();
-        commandsQueue.pop();
+    std::cout << "Total characters processed: " << session->getPromptEngine().getFileContents().length() << std::endl;
+}
+
+void printAvailableFiles() {
+    std::cout << "Files at current path: " << std::endl;
+    for(const auto& file : session->terminal.getFilesAtCurrentPath()){
+        std::cout << file << std::endl;
     }
-    std::cout << "Sent message to GPT: " << lastCommandParsed << std::endl;
-    chatProcess(lastCommandParsed);
-    return;
 }
 
 void chatProcess(const std::string& message) {
@@ -1414,89 +2489,31 @@ void chatProcess(const std::string& message) {
         return;
     }
     if(message == "exit"){
-        exitFlag = true;
+        session->exitFlag = true;
         return;
     }
     if(message == "clear"){
         sendTerminalCommand("clear");
         return;
     }
-    if (openAIPromptEngine.getAPIKey().empty()) {
+    if (session->getPromptEngine().getAPIKey().empty()) {
         std::cerr << "Error: No OpenAPI key set. Please set the API key using 'ai apikey set [KEY]'." << std::endl;
+        session->lastCommandStatus = 1;
         return;
     }
-    std::string response = openAIPromptEngine.chatGPT(message,false);
+    std::string response = session->getPromptEngine().chatGPT(message,false);
     std::cout << "ChatGPT:\n" << response << std::endl;
 }
 
 void showChatHistory() {
-    if (!openAIPromptEngine.getChatCache().empty()) {
+    if (!session->getPromptEngine().getChatCache().empty()) {
         std::cout << "Chat history:" << std::endl;
-        for (const auto& message : openAIPromptEngine.getChatCache()) {
+        for (const auto& message : session->getPromptEngine().getChatCache()) {
             std::cout << message << std::endl;
         }
     }
 }
 
-bool checkForUpdate() {
-    std::cout << "Checking for updates..." << std::endl;
-    auto isNewerVersion = [](const std::string &latest, const std::string &current) -> bool {
-        auto splitVersion = [](const std::string &ver) {
-            std::vector<int> parts;
-            std::istringstream iss(ver);
-            std::string token;
-            while (std::getline(iss, token, '.')) {
-                parts.push_back(std::stoi(token));
-            }
-            return parts;
-        };
-        std::vector<int> latestParts = splitVersion(latest);
-        std::vector<int> currentParts = splitVersion(current);
-        size_t len = std::max(latestParts.size(), currentParts.size());
-        latestParts.resize(len, 0);
-        currentParts.resize(len, 0);
-        for (size_t i = 0; i < len; i++) {
-            if (latestParts[i] > currentParts[i]) return true;
-            if (latestParts[i] < currentParts[i]) return false;
-        }
-        return false;
-    };
-
-    std::string command = "curl -s " + updateURL;
-    std::string result;
-    FILE *pipe = popen(command.c_str(), "r");
-    if (!pipe) {
-        std::cerr << "Error: Unable to execute update check or no internet connection." << std::endl;
-        return false;
-    }
-    char buffer[128];
-    while (fgets(buffer, 128, pipe) != nullptr) {
-        result += buffer;
-    }
-    pclose(pipe);
-
-    try {
-        json jsonData = json::parse(result);
-        if (jsonData.contains("tag_name")) {
-            std::string latestTag = jsonData["tag_name"].get<std::string>();
-            if (!latestTag.empty() && latestTag[0] == 'v') {
-                latestTag = latestTag.substr(1);
-            }
-            std::string currentVer = currentVersion;
-            if (!currentVer.empty() && currentVer[0] == 'v') {
-                currentVer = currentVer.substr(1);
-            }
-            if (isNewerVersion(latestTag, currentVer)) {
-                std::cout << currentVersion << " -> " << latestTag << std::endl;
-                return true;
-            }
-        }
-    } catch (std::exception &e) {
-        std::cerr << "Error: " << e.what() << std::endl;
-    }
-    return false;
-}
-
 bool isDownloadURLValid(const std::string& url) {
     std::string command = "curl -Is " + url + " | head -n 1";
     FILE* pipe = popen(command.c_str(), "r");
@@ -1518,6 +2535,7 @@ bool downloadLatestRelease(){
     FILE* pipe = popen(curlCmd.c_str(), "r");
     if(!pipe){
         std::cerr << "Error: Unable to fetch release information." << std::endl;
+        session->lastCommandStatus = 1;
         return false;
     }
     char buffer[128];
@@ -1527,12 +2545,14 @@ bool downloadLatestRelease(){
     pclose(pipe);
     if(releaseJson.empty()){
         std::cerr << "Error: Empty response when fetching release info." << std::endl;
+        session->lastCommandStatus = 1;
         return false;
     }
     try {
         json releaseData = json::parse(releaseJson);
         if(!releaseData.contains("assets") || !releaseData["assets"].is_array() || releaseData["assets"].empty()){
             std::cerr << "Error: No assets found in the latest release." << std::endl;
+            session->lastCommandStatus = 1;
             return false;
         }
         std::string downloadUrl;
@@ -1552,6 +2572,7 @@ bool downloadLatestRelease(){
         #endif
         if (downloadUrl.empty() || !isDownloadURLValid(downloadUrl)) {
             std::cerr << "Error: Invalid download URL or no internet connection." << std::endl;
+            session->lastCommandStatus = 1;
             return false;
         }
         size_t pos = downloadUrl.find_last_of('/');
@@ -1570,6 +2591,7 @@ bool downloadLatestRelease(){
             #endif
             if(std::rename(downloadPath.c_str(), exePath.c_str()) != 0){
                 std::cerr << "Error: Failed to replace the current executable." << std::endl;
+                session->lastCommandStatus = 1;
                 return false;
             }
             std::ofstream changelogFile(DATA_DIRECTORY / "CHANGELOG.txt");
@@ -1579,13 +2601,16 @@ bool downloadLatestRelease(){
             }
             execl(exePath.c_str(), exePath.c_str(), (char*)NULL);
             std::cerr << "Error: Failed to execute the updated program." << std::endl;
+            session->lastCommandStatus = 1;
             return false;
         } else {
             std::cerr << "Error: Download command failed." << std::endl;
+            session->lastCommandStatus = 1;
             return false;
         }
     } catch(std::exception &e) {
         std::cerr << "Error parsing release JSON: " << e.what() << std::endl;
+        session->lastCommandStatus = 1;
         return false;
     }
 }
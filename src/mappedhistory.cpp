@@ -0,0 +1,448 @@
+#include "mappedhistory.h"
+#include <algorithm>
+#include <cerrno>
+#include <iterator>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char DATA_MAGIC[4] = {'D', 'T', 'T', 'H'};
+static const char INDEX_MAGIC[4] = {'D', 'T', 'T', 'I'};
+static const uint8_t FORMAT_VERSION = 1;
+
+static void appendVarint(std::string& output, uint64_t value) {
+    while (value >= 0x80) {
+        output += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    output += static_cast<char>(value);
+}
+
+static bool readVarint(const char* data, size_t length, size_t& offset, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && offset < length; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(data[offset++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool readString(const char* data, size_t length, size_t& offset, std::string& value) {
+    uint64_t size;
+    if (!readVarint(data, length, offset, size) || size > length - offset) {
+        return false;
+    }
+    value.assign(data + offset, size);
+    offset += size;
+    return true;
+}
+
+MappedHistory::MappedHistory() {}
+
+MappedHistory::~MappedHistory() {
+    close();
+}
+
+MappedHistory::MappedHistory(MappedHistory&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedHistory& MappedHistory::operator=(MappedHistory&& other) noexcept {
+    if (this != &other) {
+        close();
+        filePath = std::move(other.filePath);
+        device = other.device;
+        inode = other.inode;
+        data = other.data;
+        length = other.length;
+        fileId = other.fileId;
+        coveredLength = other.coveredLength;
+        indexPath = std::move(other.indexPath);
+        index = std::move(other.index);
+        other.data = nullptr;
+        other.length = 0;
+        other.index.clear();
+    }
+    return *this;
+}
+
+bool MappedHistory::open(const std::filesystem::path& file) {
+    close();
+    int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    bool mapped = ::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= HEADER_SIZE &&
+        map(fd, static_cast<size_t>(info.st_size));
+    ::close(fd);
+    if (!mapped) {
+        return false;
+    }
+    filePath = file;
+    device = info.st_dev;
+    inode = info.st_ino;
+    if (std::memcmp(data, DATA_MAGIC, 4) != 0 || static_cast<uint8_t>(data[4]) != FORMAT_VERSION) {
+        close();
+        return false;
+    }
+    std::memcpy(&fileId, data + 8, sizeof(fileId));
+    indexPath = getIndexPath(file);
+    bool rewrite = !loadIndex();
+    size_t previousCount = index.size();
+    extendIndex();
+    if (rewrite || index.size() != previousCount) {
+        saveIndex(previousCount, rewrite);
+    }
+    return true;
+}
+
+void MappedHistory::close() {
+    if (data != nullptr) {
+        ::munmap(const_cast<char*>(data), length);
+    }
+    data = nullptr;
+    length = 0;
+    device = 0;
+    inode = 0;
+    fileId = 0;
+    coveredLength = 0;
+    index.clear();
+}
+
+bool MappedHistory::refresh() {
+    struct stat info;
+    if (filePath.empty() || ::stat(filePath.c_str(), &info) != 0) {
+        return false;
+    }
+    if (data != nullptr && info.st_dev == device && info.st_ino == inode) {
+        if (static_cast<size_t>(info.st_size) <= length) {
+            return false;
+        }
+        int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat opened;
+        if (::fstat(fd, &opened) == 0 && opened.st_ino == inode && opened.st_dev == device) {
+            size_t previousCount = index.size();
+            const char* previousData = data;
+            size_t previousLength = length;
+            if (map(fd, static_cast<size_t>(opened.st_size))) {
+                ::munmap(const_cast<char*>(previousData), previousLength);
+                extendIndex();
+                ::close(fd);
+                return index.size() != previousCount;
+            }
+        }
+        ::close(fd);
+        return false;
+    }
+    std::filesystem::path file = filePath;
+    return open(file);
+}
+
+bool MappedHistory::isOpen() const {
+    return data != nullptr;
+}
+
+size_t MappedHistory::size() const {
+    return index.size();
+}
+
+size_t MappedHistory::getIndexedLength() const {
+    return coveredLength;
+}
+
+uint64_t MappedHistory::getFileId() const {
+    return fileId;
+}
+
+bool MappedHistory::getRecord(size_t position, HistoryRecord& record) const {
+    if (position >= index.size()) {
+        return false;
+    }
+    size_t offset = index[position].offset;
+    return decodeRecord(data, length, offset, record);
+}
+
+bool MappedHistory::getFromEnd(size_t offset, std::string& command) const {
+    HistoryRecord record;
+    if (offset >= index.size() || !getRecord(index.size() - 1 - offset, record)) {
+        return false;
+    }
+    command = std::move(record.command);
+    return true;
+}
+
+time_t MappedHistory::getTimestamp(size_t position) const {
+    return static_cast<time_t>(index[position].timestamp);
+}
+
+size_t MappedHistory::lowerBound(time_t timestamp) const {
+    auto it = std::partition_point(index.begin(), index.end(), [timestamp](const IndexEntry& entry) {
+        return entry.timestamp < static_cast<int64_t>(timestamp);
+    });
+    return it - index.begin();
+}
+
+size_t MappedHistory::upperBound(time_t timestamp) const {
+    auto it = std::partition_point(index.begin(), index.end(), [timestamp](const IndexEntry& entry) {
+        return entry.timestamp <= static_cast<int64_t>(timestamp);
+    });
+    return it - index.begin();
+}
+
+std::string MappedHistory::createHeader() {
+    std::string header(DATA_MAGIC, 4);
+    header += static_cast<char>(FORMAT_VERSION);
+    header.append(3, '\0');
+    std::random_device device;
+    uint64_t id = (static_cast<uint64_t>(device()) << 32) ^ device() ^ static_cast<uint64_t>(time(nullptr));
+    header.append(reinterpret_cast<const char*>(&id), sizeof(id));
+    return header;
+}
+
+std::string MappedHistory::encodeRecord(const HistoryRecord& record) {
+    std::string payload;
+    appendVarint(payload, static_cast<uint64_t>(record.timestamp));
+    appendVarint(payload, record.durationMs);
+    int64_t status = record.exitStatus;
+    appendVarint(payload, (static_cast<uint64_t>(status) << 1) ^ static_cast<uint64_t>(status >> 63));
+    appendVarint(payload, record.directory.size());
+    payload += record.directory;
+    appendVarint(payload, record.command.size());
+    payload += record.command;
+    if (record.count > 1) {
+        appendVarint(payload, record.count);
+    }
+    std::string encoded;
+    appendVarint(encoded, payload.size());
+    encoded += payload;
+    return encoded;
+}
+
+bool MappedHistory::decodeRecord(const char* data, size_t length, size_t& offset, HistoryRecord& record) {
+    uint64_t payloadSize;
+    size_t position = offset;
+    if (!readVarint(data, length, position, payloadSize) || payloadSize > length - position) {
+        return false;
+    }
+    size_t end = position + payloadSize;
+    uint64_t timestamp;
+    uint64_t duration;
+    uint64_t status;
+    if (!readVarint(data, end, position, timestamp) || !readVarint(data, end, position, duration) ||
+        !readVarint(data, end, position, status) || !readString(data, end, position, record.directory) ||
+        !readString(data, end, position, record.command)) {
+        return false;
+    }
+    record.timestamp = static_cast<time_t>(timestamp);
+    record.durationMs = static_cast<uint32_t>(duration);
+    record.exitStatus = static_cast<int>(static_cast<int64_t>(status >> 1) ^ -static_cast<int64_t>(status & 1));
+    uint64_t count = 1;
+    if (position < end && !readVarint(data, end, position, count)) {
+        return false;
+    }
+    record.count = static_cast<uint32_t>(std::max<uint64_t>(count, 1));
+    offset = end;
+    return true;
+}
+
+bool MappedHistory::isUnderDirectory(const std::string& directory, const std::string& root) {
+    return directory.compare(0, root.size(), root) == 0 &&
+        (directory.size() == root.size() || directory[root.size()] == '/' || root.back() == '/');
+}
+
+std::filesystem::path MappedHistory::getIndexPath(const std::filesystem::path& file) {
+    std::filesystem::path indexFile = file;
+    indexFile.replace_extension(".idx");
+    return indexFile;
+}
+
+bool MappedHistory::migrateTextHistory(const std::filesystem::path& textFile, const std::filesystem::path& binaryFile, size_t& migrated) {
+    migrated = 0;
+    std::ifstream input(textFile);
+    if (!input.is_open()) {
+        return false;
+    }
+    std::vector<HistoryRecord> records;
+    std::string line;
+    while (std::getline(input, line)) {
+        HistoryRecord record;
+        size_t separator = line.find(' ');
+        if (separator == std::string::npos || separator + 1 >= line.size()) {
+            continue;
+        }
+        try {
+            record.timestamp = static_cast<time_t>(std::stoll(line.substr(0, separator)));
+        } catch (const std::exception&) {
+            continue;
+        }
+        record.command = line.substr(separator + 1);
+        records.push_back(std::move(record));
+    }
+    auto olderThan = [](const HistoryRecord& a, const HistoryRecord& b) {
+        return a.timestamp < b.timestamp;
+    };
+    std::stable_sort(records.begin(), records.end(), olderThan);
+
+    int lockFd = -1;
+    while ((lockFd = ::open(binaryFile.c_str(), O_RDONLY | O_CLOEXEC)) >= 0) {
+        while (::flock(lockFd, LOCK_EX) != 0 && errno == EINTR) {}
+        struct stat locked;
+        struct stat current;
+        if (::fstat(lockFd, &locked) == 0 && ::stat(binaryFile.c_str(), &current) == 0 &&
+            locked.st_dev == current.st_dev && locked.st_ino == current.st_ino) {
+            break;
+        }
+        ::close(lockFd);
+    }
+    std::vector<HistoryRecord> existingRecords;
+    MappedHistory existing;
+    if (lockFd >= 0 && existing.open(binaryFile)) {
+        HistoryRecord record;
+        for (size_t i = 0; i < existing.size(); i++) {
+            if (existing.getRecord(i, record)) {
+                existingRecords.push_back(record);
+            }
+        }
+    }
+    existing.close();
+    std::vector<HistoryRecord> merged;
+    merged.reserve(existingRecords.size() + records.size());
+    std::merge(existingRecords.begin(), existingRecords.end(), records.begin(), records.end(), std::back_inserter(merged), olderThan);
+
+    std::filesystem::path temporary = binaryFile;
+    temporary += ".tmp";
+    std::ofstream output(temporary, std::ios::binary | std::ios::trunc);
+    bool success = output.is_open();
+    if (success) {
+        output << createHeader();
+        for (const HistoryRecord& record : merged) {
+            output << encodeRecord(record);
+        }
+        output.close();
+        success = static_cast<bool>(output);
+    }
+    std::error_code ec;
+    if (success) {
+        std::filesystem::rename(temporary, binaryFile, ec);
+        success = !ec;
+    }
+    if (lockFd >= 0) {
+        ::flock(lockFd, LOCK_UN);
+        ::close(lockFd);
+    }
+    if (!success) {
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    migrated = records.size();
+    std::filesystem::remove(getIndexPath(binaryFile), ec);
+    return true;
+}
+
+bool MappedHistory::map(int fd, size_t size) {
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    data = static_cast<const char*>(mapped);
+    length = size;
+    return true;
+}
+
+bool MappedHistory::loadIndex() {
+    index.clear();
+    coveredLength = HEADER_SIZE;
+    std::ifstream file(indexPath, std::ios::binary);
+    char header[INDEX_HEADER_SIZE];
+    if (!file.read(header, INDEX_HEADER_SIZE) || std::memcmp(header, INDEX_MAGIC, 4) != 0) {
+        return false;
+    }
+    uint32_t version;
+    uint64_t indexedFileId;
+    uint64_t covered;
+    std::memcpy(&version, header + 4, sizeof(version));
+    std::memcpy(&indexedFileId, header + 8, sizeof(indexedFileId));
+    std::memcpy(&covered, header + 16, sizeof(covered));
+    if (version != FORMAT_VERSION || indexedFileId != fileId || covered > length || covered < HEADER_SIZE) {
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    size_t entryCount = (static_cast<size_t>(file.tellg()) - INDEX_HEADER_SIZE) / sizeof(IndexEntry);
+    file.seekg(INDEX_HEADER_SIZE);
+    index.resize(entryCount);
+    if (entryCount > 0 && !file.read(reinterpret_cast<char*>(index.data()), entryCount * sizeof(IndexEntry))) {
+        index.clear();
+        return false;
+    }
+    if (!index.empty()) {
+        HistoryRecord record;
+        size_t offset = index.back().offset;
+        if (!decodeRecord(data, length, offset, record) || offset != covered) {
+            index.clear();
+            return false;
+        }
+    } else if (covered != HEADER_SIZE) {
+        return false;
+    }
+    coveredLength = covered;
+    return true;
+}
+
+void MappedHistory::extendIndex() {
+    size_t offset = coveredLength;
+    HistoryRecord record;
+    while (offset < length) {
+        size_t start = offset;
+        if (!decodeRecord(data, length, offset, record)) {
+            break;
+        }
+        index.push_back({start, static_cast<int64_t>(record.timestamp)});
+        coveredLength = offset;
+    }
+}
+
+void MappedHistory::saveIndex(size_t previousCount, bool rewrite) const {
+    char header[INDEX_HEADER_SIZE];
+    uint32_t version = FORMAT_VERSION;
+    std::memcpy(header, INDEX_MAGIC, 4);
+    std::memcpy(header + 4, &version, sizeof(version));
+    std::memcpy(header + 8, &fileId, sizeof(fileId));
+    std::memcpy(header + 16, &coveredLength, sizeof(coveredLength));
+    std::error_code ec;
+    if (rewrite) {
+        std::filesystem::path temporary = indexPath;
+        temporary += ".tmp";
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(header, INDEX_HEADER_SIZE);
+        file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(IndexEntry));
+        file.close();
+        if (file) {
+            std::filesystem::rename(temporary, indexPath, ec);
+        } else {
+            std::filesystem::remove(temporary, ec);
+        }
+        return;
+    }
+    int fd = ::open(indexPath.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    size_t added = index.size() - previousCount;
+    ssize_t written = ::pwrite(fd, index.data() + previousCount, added * sizeof(IndexEntry), INDEX_HEADER_SIZE + previousCount * sizeof(IndexEntry));
+    if (written == static_cast<ssize_t>(added * sizeof(IndexEntry))) {
+        ::pwrite(fd, header, INDEX_HEADER_SIZE, 0);
+    }
+    ::close(fd);
+}
@@ -0,0 +1,75 @@
+#ifndef MAPPEDHISTORY_H
+#define MAPPEDHISTORY_H
+#include <string>
+#include <vector>
+#include <ctime>
+#include <cstdint>
+#include <filesystem>
+#include <sys/types.h>
+
+struct HistoryRecord {
+    time_t timestamp = 0;
+    uint32_t durationMs = 0;
+    int exitStatus = 0;
+    uint32_t count = 1;
+    std::string directory;
+    std::string command;
+};
+
+class MappedHistory {
+public:
+    MappedHistory();
+    ~MappedHistory();
+    MappedHistory(const MappedHistory&) = delete;
+    MappedHistory& operator=(const MappedHistory&) = delete;
+    MappedHistory(MappedHistory&& other) noexcept;
+    MappedHistory& operator=(MappedHistory&& other) noexcept;
+
+    bool open(const std::filesystem::path& file);
+    void close();
+    bool refresh();
+    bool isOpen() const;
+    size_t size() const;
+    size_t getIndexedLength() const;
+    uint64_t getFileId() const;
+    bool getRecord(size_t index, HistoryRecord& record) const;
+    bool getFromEnd(size_t offset, std::string& command) const;
+    time_t getTimestamp(size_t index) const;
+    size_t lowerBound(time_t timestamp) const;
+    size_t upperBound(time_t timestamp) const;
+
+    static std::string createHeader();
+    static std::string encodeRecord(const HistoryRecord& record);
+    static bool decodeRecord(const char* data, size_t length, size_t& offset, HistoryRecord& record);
+    static bool isUnderDirectory(const std::string& directory, const std::string& root);
+    static std::filesystem::path getIndexPath(const std::filesystem::path& file);
+    static bool migrateTextHistory(const std::filesystem::path& textFile, const std::filesystem::path& binaryFile, size_t& migrated);
+
+    static const size_t HEADER_SIZE = 16;
+
+private:
+    struct IndexEntry {
+        uint64_t offset;
+        int64_t timestamp;
+    };
+
+    bool loadIndex();
+    void extendIndex();
+    void saveIndex(size_t previousCount, bool rewrite) const;
+
+    bool map(int fd, size_t size);
+
+    std::filesystem::path filePath;
+    dev_t device = 0;
+    ino_t inode = 0;
+    const char* data = nullptr;
+    size_t length = 0;
+    uint64_t fileId = 0;
+    uint64_t coveredLength = 0;
+    std::filesystem::path indexPath;
+    std::vector<IndexEntry> index;
+
+    static const size_t INDEX_HEADER_SIZE = 24;
+};
+
+#endif // MAPPEDHISTORY_H
@@ -0,0 +1,19 @@
+#include "session.h"
+#include <mutex>
+
+static std::once_flag curlInitialized;
+
+Session::Session() {}
+
+OpenAIPromptEngine& Session::getPromptEngine() {
+    if (!promptEngine) {
+        std::call_once(curlInitialized, [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+        promptEngine = std::make_unique<OpenAIPromptEngine>(openAIAPIKey, "chat", "You are an AI personal assistant within a terminal application.", std::vector<std::string>(), ".DTT-Data");
+        promptEngine->setChatCache(savedChatCache);
+    }
+    return *promptEngine;
+}
+
+bool Session::hasPromptEngine() const {
+    return promptEngine != nullptr;
+}
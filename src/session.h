@@ -0,0 +1,53 @@
+#ifndef SESSION_H
+#define SESSION_H
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "terminalpassthrough.h"
+#include "openaipromptengine.h"
+#include "commandarena.h"
+#include "shortcutplan.h"
+#include "shortcuttemplate.h"
+
+class Session {
+public:
+    Session();
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    OpenAIPromptEngine& getPromptEngine();
+    bool hasPromptEngine() const;
+
+    TerminalPassthrough terminal;
+    CommandArena commandArena;
+
+    std::string commandPrefix = "!";
+    std::string openAIAPIKey;
+    std::vector<std::string> startupCommands;
+    std::vector<std::string> savedChatCache;
+    std::map<std::string, std::string> shortcuts;
+    std::map<std::string, ShortcutTemplate> shortcutTemplates;
+    std::map<std::string, std::vector<std::string>> multiScriptShortcuts;
+    std::map<std::string, ShortcutPlan> compiledShortcuts;
+    std::set<std::string> templatedShortcuts;
+    std::set<std::string> templatedMultiScriptShortcuts;
+
+    bool shotcutsEnabled = true;
+    bool startCommandsOn = true;
+    bool runningStartup = false;
+    bool defaultTextEntryOnAI = false;
+    bool exitFlag = false;
+    bool testing = false;
+    bool saveLoop = false;
+    bool saveOnExit = true;
+    bool checkForUpdates = true;
+    int lastCommandStatus = 0;
+    int scriptDepth = 0;
+
+private:
+    std::unique_ptr<OpenAIPromptEngine> promptEngine;
+};
+
+#endif // SESSION_H
@@ -0,0 +1,198 @@
+#include "shortcutplan.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+static std::string trim(const std::string& text) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return "";
+    }
+    return text.substr(start, text.find_last_not_of(" \t") - start + 1);
+}
+
+ShortcutPlan::ShortcutPlan() {}
+
+bool ShortcutPlan::compile(const std::vector<std::string>& commands, bool templated, std::string& error) {
+    steps.clear();
+    std::unordered_map<std::string, size_t> names;
+    size_t barrier = SIZE_MAX;
+    for (size_t i = 0; i < commands.size(); i++) {
+        Step step;
+        std::string text = trim(commands[i]);
+        if (text.rfind('@', 0) == 0) {
+            size_t end = text.find_first_of(" \t(");
+            step.name = text.substr(1, end == std::string::npos ? std::string::npos : end - 1);
+            step.labelled = true;
+            if (step.name.empty()) {
+                error = "Step " + std::to_string(i + 1) + " has an empty name.";
+                return false;
+            }
+            if (names.count(step.name) > 0) {
+                error = "Step name '" + step.name + "' is used more than once.";
+                return false;
+            }
+            if (end != std::string::npos && text[end] == '(') {
+                size_t close = text.find(')', end);
+                if (close == std::string::npos) {
+                    error = "Missing ')' after the dependencies of step '" + step.name + "'.";
+                    return false;
+                }
+                std::string list = text.substr(end + 1, close - end - 1);
+                size_t start = 0;
+                while (start <= list.size()) {
+                    size_t comma = list.find(',', start);
+                    if (comma == std::string::npos) {
+                        comma = list.size();
+                    }
+                    std::string dependency = trim(list.substr(start, comma - start));
+                    start = comma + 1;
+                    if (dependency.empty()) {
+                        continue;
+                    }
+                    auto it = names.find(dependency);
+                    if (it == names.end()) {
+                        error = "Step '" + step.name + "' depends on '" + dependency + "', which is not an earlier step.";
+                        return false;
+                    }
+                    step.dependencies.push_back(it->second);
+                }
+                end = close + 1;
+            }
+            text = end == std::string::npos ? "" : trim(text.substr(end));
+            if (barrier != SIZE_MAX) {
+                step.after.push_back(barrier);
+            }
+            names[step.name] = i;
+        } else {
+            step.name = std::to_string(i + 1);
+            for (size_t previous = barrier == SIZE_MAX ? 0 : barrier; previous < i; previous++) {
+                step.after.push_back(previous);
+            }
+            barrier = i;
+        }
+        if (text.empty()) {
+            error = "Step '" + step.name + "' has no command.";
+            return false;
+        }
+        step.command = text;
+        step.shell = text.rfind("terminal ", 0) == 0 && !trim(text.substr(9)).empty();
+        if (!templated) {
+            step.commandTemplate.compileLiteral(text);
+        } else if (!step.commandTemplate.compile(text, error)) {
+            error = "Step '" + step.name + "': " + error;
+            return false;
+        }
+        steps.push_back(step);
+    }
+    for (size_t i = 0; i < steps.size(); i++) {
+        for (size_t dependency : steps[i].dependencies) {
+            steps[dependency].dependents.push_back(i);
+        }
+        for (size_t dependency : steps[i].after) {
+            steps[dependency].dependents.push_back(i);
+        }
+    }
+    return true;
+}
+
+const std::vector<ShortcutPlan::Step>& ShortcutPlan::getSteps() const {
+    return steps;
+}
+
+std::vector<std::string> ShortcutPlan::getParameterNames() const {
+    std::vector<std::string> names;
+    for (const Step& step : steps) {
+        for (const std::string& name : step.commandTemplate.getParameterNames()) {
+            if (std::find(names.begin(), names.end(), name) == names.end()) {
+                names.push_back(name);
+            }
+        }
+    }
+    return names;
+}
+
+bool ShortcutPlan::isParallel(const Step& step) const {
+    return step.labelled && step.shell;
+}
+
+std::vector<ShortcutPlan::StepResult> ShortcutPlan::execute(WorkerPool& pool, const Runner& runner) const {
+    std::vector<StepResult> results(steps.size());
+    std::vector<size_t> waiting(steps.size());
+    std::vector<bool> blocked(steps.size(), false);
+    std::deque<size_t> ready;
+    std::deque<size_t> deferred;
+    std::deque<size_t> finished;
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t completed = 0;
+    size_t running = 0;
+
+    for (size_t i = 0; i < steps.size(); i++) {
+        waiting[i] = steps[i].dependencies.size() + steps[i].after.size();
+        if (waiting[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+    auto runStep = [this, &runner, &results](size_t index) {
+        auto start = std::chrono::steady_clock::now();
+        int status = runner(index);
+        results[index].status = status;
+        results[index].milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (completed < steps.size()) {
+        while (!ready.empty() || (running == 0 && !deferred.empty())) {
+            if (ready.empty()) {
+                ready.swap(deferred);
+            }
+            size_t index = ready.front();
+            ready.pop_front();
+            if (blocked[index]) {
+                results[index].skipped = true;
+                finished.push_back(index);
+                continue;
+            }
+            if (isParallel(steps[index])) {
+                running++;
+                pool.submit([&, index] {
+                    runStep(index);
+                    std::lock_guard<std::mutex> guard(mutex);
+                    running--;
+                    finished.push_back(index);
+                    done.notify_one();
+                });
+                continue;
+            }
+            if (running > 0) {
+                deferred.push_back(index);
+                continue;
+            }
+            lock.unlock();
+            runStep(index);
+            lock.lock();
+            finished.push_back(index);
+        }
+        done.wait(lock, [&] { return !finished.empty(); });
+        while (!finished.empty()) {
+            size_t index = finished.front();
+            finished.pop_front();
+            completed++;
+            bool failed = results[index].skipped || results[index].status != 0;
+            for (size_t dependent : steps[index].dependents) {
+                const std::vector<size_t>& dependencies = steps[dependent].dependencies;
+                if (failed && std::find(dependencies.begin(), dependencies.end(), index) != dependencies.end()) {
+                    blocked[dependent] = true;
+                }
+                if (--waiting[dependent] == 0) {
+                    ready.push_back(dependent);
+                }
+            }
+        }
+    }
+    return results;
+}
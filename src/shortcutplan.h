@@ -0,0 +1,42 @@
+#ifndef SHORTCUTPLAN_H
+#define SHORTCUTPLAN_H
+#include <string>
+#include <vector>
+#include <functional>
+#include "workerpool.h"
+#include "shortcuttemplate.h"
+
+class ShortcutPlan {
+public:
+    struct Step {
+        std::string name;
+        std::string command;
+        ShortcutTemplate commandTemplate;
+        bool shell = false;
+        bool labelled = false;
+        std::vector<size_t> dependencies;
+        std::vector<size_t> after;
+        std::vector<size_t> dependents;
+    };
+
+    struct StepResult {
+        int status = 0;
+        bool skipped = false;
+        double milliseconds = 0;
+    };
+
+    using Runner = std::function<int(size_t)>;
+
+    ShortcutPlan();
+
+    bool compile(const std::vector<std::string>& commands, bool templated, std::string& error);
+    const std::vector<Step>& getSteps() const;
+    std::vector<std::string> getParameterNames() const;
+    bool isParallel(const Step& step) const;
+    std::vector<StepResult> execute(WorkerPool& pool, const Runner& runner) const;
+
+private:
+    std::vector<Step> steps;
+};
+
+#endif // SHORTCUTPLAN_H
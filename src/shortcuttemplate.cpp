@@ -0,0 +1,231 @@
+#include "shortcuttemplate.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <ctime>
+
+static const char* VARIABLES[] = {"cwd", "home", "user", "date", "time"};
+
+static bool isIdentifier(std::string_view text) {
+    if (text.empty() || std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    return std::all_of(text.begin(), text.end(), [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    });
+}
+
+static bool isIndex(std::string_view text) {
+    return !text.empty() && text[0] != '0' && std::all_of(text.begin(), text.end(), [](char c) {
+        return std::isdigit(static_cast<unsigned char>(c));
+    });
+}
+
+static std::string getVariable(const std::string& name, const std::string& cwd) {
+    if (name == "cwd") {
+        return cwd;
+    }
+    if (name == "home" || name == "user") {
+        const char* value = std::getenv(name == "home" ? "HOME" : "USER");
+        return value == nullptr ? "" : value;
+    }
+    time_t now = time(nullptr);
+    char buffer[32];
+    strftime(buffer, sizeof(buffer), name == "date" ? "%Y-%m-%d" : "%H:%M:%S", localtime(&now));
+    return buffer;
+}
+
+ShortcutTemplate::ShortcutTemplate() {}
+
+bool ShortcutTemplate::compile(const std::string& text, std::string& error) {
+    segments.clear();
+    parameterNames.clear();
+    textLength = 0;
+    shell = text.rfind("terminal ", 0) == 0;
+    std::string_view source = text;
+    size_t i = 0;
+    while (i < source.size()) {
+        size_t next = source.find('$', i);
+        if (next == std::string_view::npos || next + 1 >= source.size()) {
+            appendText(source.substr(i));
+            break;
+        }
+        appendText(source.substr(i, next - i));
+        char marker = source[next + 1];
+        Segment segment;
+        if (marker == '$') {
+            appendText("$$");
+            i = next + 2;
+            continue;
+        }
+        if (marker == '@') {
+            segment.type = SegmentType::AllPositional;
+            segments.push_back(segment);
+            i = next + 2;
+            continue;
+        }
+        if (std::isdigit(static_cast<unsigned char>(marker)) && marker != '0') {
+            size_t end = next + 1;
+            while (end < source.size() && std::isdigit(static_cast<unsigned char>(source[end]))) {
+                end++;
+            }
+            segment.type = SegmentType::Positional;
+            segment.index = std::strtoull(std::string(source.substr(next + 1, end - next - 1)).c_str(), nullptr, 10);
+            segments.push_back(segment);
+            i = end;
+            continue;
+        }
+        char closing = marker == '{' ? '}' : marker == '(' ? ')' : '\0';
+        size_t close = closing == '\0' ? std::string_view::npos : source.find(closing, next + 2);
+        if (close == std::string_view::npos && marker == '{') {
+            error = "Missing '}' after '${' at position " + std::to_string(next + 1) + ".";
+            return false;
+        }
+        if (close == std::string_view::npos) {
+            appendText("$");
+            i = next + 1;
+            continue;
+        }
+        std::string_view body = source.substr(next + 2, close - next - 2);
+        if (marker == '(') {
+            if (std::find(std::begin(VARIABLES), std::end(VARIABLES), body) == std::end(VARIABLES)) {
+                appendText(source.substr(next, close - next + 1));
+            } else {
+                segment.type = SegmentType::Variable;
+                segment.text = body;
+                segments.push_back(segment);
+            }
+            i = close + 1;
+            continue;
+        }
+        size_t separator = body.find(":-");
+        std::string_view name = body.substr(0, separator);
+        if (separator != std::string_view::npos) {
+            segment.fallback = body.substr(separator + 2);
+            segment.hasFallback = true;
+        }
+        if (isIndex(name)) {
+            segment.type = SegmentType::Positional;
+            segment.index = std::strtoull(std::string(name).c_str(), nullptr, 10);
+        } else if (isIdentifier(name)) {
+            segment.type = SegmentType::Named;
+            segment.text = name;
+            if (std::find(parameterNames.begin(), parameterNames.end(), segment.text) == parameterNames.end()) {
+                parameterNames.push_back(segment.text);
+            }
+        } else {
+            appendText(source.substr(next, close - next + 1));
+            i = close + 1;
+            continue;
+        }
+        segments.push_back(segment);
+        i = close + 1;
+    }
+    return true;
+}
+
+void ShortcutTemplate::compileLiteral(const std::string& text) {
+    segments.clear();
+    parameterNames.clear();
+    textLength = 0;
+    shell = false;
+    appendText(text);
+}
+
+bool ShortcutTemplate::expand(const Arguments& arguments, std::string& result, std::string& error) const {
+    result.clear();
+    result.reserve(textLength + arguments.cwd.size());
+    for (const Segment& segment : segments) {
+        switch (segment.type) {
+            case SegmentType::Text:
+                result += segment.text;
+                break;
+            case SegmentType::Positional:
+                if (segment.index <= arguments.positional.size()) {
+                    appendValue(result, arguments.positional[segment.index - 1]);
+                } else if (segment.hasFallback) {
+                    appendValue(result, segment.fallback);
+                } else {
+                    error = "Missing argument $" + std::to_string(segment.index) + ".";
+                    return false;
+                }
+                break;
+            case SegmentType::AllPositional:
+                for (size_t i = 0; i < arguments.positional.size(); i++) {
+                    result.append(i == 0 ? "" : " ");
+                    appendValue(result, arguments.positional[i]);
+                }
+                break;
+            case SegmentType::Named: {
+                auto it = std::find_if(arguments.named.rbegin(), arguments.named.rend(), [&segment](const auto& entry) {
+                    return entry.first == segment.text;
+                });
+                const char* environment = it == arguments.named.rend() ? std::getenv(segment.text.c_str()) : nullptr;
+                if (it != arguments.named.rend()) {
+                    appendValue(result, it->second);
+                } else if (environment != nullptr) {
+                    appendValue(result, environment);
+                } else if (segment.hasFallback) {
+                    appendValue(result, segment.fallback);
+                } else {
+                    error = "Missing value for ${" + segment.text + "}. Pass it as " + segment.text + "=VALUE.";
+                    return false;
+                }
+                break;
+            }
+            case SegmentType::Variable:
+                appendValue(result, getVariable(segment.text, arguments.cwd));
+                break;
+        }
+    }
+    return true;
+}
+
+bool ShortcutTemplate::isParameterized() const {
+    return segments.size() > 1 || (!segments.empty() && segments.front().type != SegmentType::Text);
+}
+
+const std::vector<std::string>& ShortcutTemplate::getParameterNames() const {
+    return parameterNames;
+}
+
+ShortcutTemplate::Arguments ShortcutTemplate::parseArguments(const std::vector<std::string_view>& tokens, const std::vector<std::string>& parameterNames, const std::string& cwd) {
+    Arguments arguments;
+    arguments.cwd = cwd;
+    for (std::string_view token : tokens) {
+        size_t equals = token.find('=');
+        if (equals != std::string_view::npos && std::find(parameterNames.begin(), parameterNames.end(), token.substr(0, equals)) != parameterNames.end()) {
+            arguments.named.emplace_back(token.substr(0, equals), token.substr(equals + 1));
+        } else {
+            arguments.positional.push_back(token);
+        }
+    }
+    return arguments;
+}
+
+void ShortcutTemplate::appendValue(std::string& result, std::string_view value) const {
+    if (!shell) {
+        result += value;
+        return;
+    }
+    result += '\'';
+    for (char c : value) {
+        if (c == '\'') {
+            result += "'\\''";
+        } else {
+            result += c;
+        }
+    }
+    result += '\'';
+}
+
+void ShortcutTemplate::appendText(std::string_view text) {
+    if (text.empty()) {
+        return;
+    }
+    if (segments.empty() || segments.back().type != SegmentType::Text) {
+        segments.push_back(Segment());
+    }
+    segments.back().text += text;
+    textLength += text.size();
+}
@@ -0,0 +1,52 @@
+#ifndef SHORTCUTTEMPLATE_H
+#define SHORTCUTTEMPLATE_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+
+class ShortcutTemplate {
+public:
+    struct Arguments {
+        std::vector<std::string_view> positional;
+        std::vector<std::pair<std::string_view, std::string_view>> named;
+        std::string cwd;
+    };
+
+    ShortcutTemplate();
+
+    bool compile(const std::string& text, std::string& error);
+    void compileLiteral(const std::string& text);
+    bool expand(const Arguments& arguments, std::string& result, std::string& error) const;
+    bool isParameterized() const;
+    const std::vector<std::string>& getParameterNames() const;
+
+    static Arguments parseArguments(const std::vector<std::string_view>& tokens, const std::vector<std::string>& parameterNames, const std::string& cwd);
+
+private:
+    enum class SegmentType {
+        Text,
+        Positional,
+        AllPositional,
+        Named,
+        Variable
+    };
+
+    struct Segment {
+        SegmentType type = SegmentType::Text;
+        std::string text;
+        size_t index = 0;
+        std::string fallback;
+        bool hasFallback = false;
+    };
+
+    void appendText(std::string_view text);
+    void appendValue(std::string& result, std::string_view value) const;
+
+    std::vector<Segment> segments;
+    std::vector<std::string> parameterNames;
+    size_t textLength = 0;
+    bool shell = false;
+};
+
+#endif // SHORTCUTTEMPLATE_H
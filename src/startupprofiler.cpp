@@ -0,0 +1,80 @@
+#include "startupprofiler.h"
+#include "nlohmann/json.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+using json = nlohmann::json;
+
+StartupProfiler::StartupProfiler() : origin(std::chrono::steady_clock::now()) {}
+
+void StartupProfiler::begin(const std::string& phase) {
+    if (finished) {
+        return;
+    }
+    end();
+    phases.push_back({phase, elapsed(), 0});
+    open = true;
+}
+
+void StartupProfiler::end() {
+    if (!open || finished) {
+        return;
+    }
+    phases.back().durationMilliseconds = elapsed() - phases.back().startMilliseconds;
+    open = false;
+}
+
+void StartupProfiler::finish() {
+    if (finished) {
+        return;
+    }
+    end();
+    totalMilliseconds = elapsed();
+    finished = true;
+}
+
+bool StartupProfiler::isFinished() const {
+    return finished;
+}
+
+std::string StartupProfiler::getSummary() const {
+    size_t width = 5;
+    for (const Phase& phase : phases) {
+        width = std::max(width, phase.name.length());
+    }
+    std::string summary = "Startup profile:\n";
+    char line[128];
+    double measured = 0;
+    for (const Phase& phase : phases) {
+        std::snprintf(line, sizeof(line), "  %-*s %10.3f ms\n", static_cast<int>(width), phase.name.c_str(), phase.durationMilliseconds);
+        summary += line;
+        measured += phase.durationMilliseconds;
+    }
+    std::snprintf(line, sizeof(line), "  %-*s %10.3f ms\n", static_cast<int>(width), "other", totalMilliseconds - measured);
+    summary += line;
+    std::snprintf(line, sizeof(line), "  %-*s %10.3f ms", static_cast<int>(width), "total", totalMilliseconds);
+    summary += line;
+    return summary;
+}
+
+bool StartupProfiler::exportToFile(const std::filesystem::path& file, const std::string& version, const std::string& mode) const {
+    json report;
+    report["version"] = version;
+    report["mode"] = mode;
+    report["total_ms"] = totalMilliseconds;
+    report["phases"] = json::array();
+    for (const Phase& phase : phases) {
+        report["phases"].push_back({{"name", phase.name}, {"start_ms", phase.startMilliseconds}, {"duration_ms", phase.durationMilliseconds}});
+    }
+    std::ofstream output(file, std::ios::trunc);
+    if (!output.is_open()) {
+        return false;
+    }
+    output << report.dump(2) << "\n";
+    return static_cast<bool>(output);
+}
+
+double StartupProfiler::elapsed() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - origin).count();
+}
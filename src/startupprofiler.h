@@ -0,0 +1,36 @@
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+#include <string>
+#include <vector>
+#include <chrono>
+#include <filesystem>
+
+class StartupProfiler {
+public:
+    StartupProfiler();
+
+    void begin(const std::string& phase);
+    void end();
+    void finish();
+    bool isFinished() const;
+
+    std::string getSummary() const;
+    bool exportToFile(const std::filesystem::path& file, const std::string& version, const std::string& mode) const;
+
+private:
+    struct Phase {
+        std::string name;
+        double startMilliseconds = 0;
+        double durationMilliseconds = 0;
+    };
+
+    double elapsed() const;
+
+    std::chrono::steady_clock::time_point origin;
+    std::vector<Phase> phases;
+    bool open = false;
+    bool finished = false;
+    double totalMilliseconds = 0;
+};
+
+#endif // STARTUPPROFILER_H
@@ -0,0 +1,231 @@
+#include "syntaxhighlighter.h"
+#include <algorithm>
+
+SyntaxHighlighter::SyntaxHighlighter() {}
+
+void SyntaxHighlighter::setClassifiers(Classifier isCommand, Classifier isPrefixCommand, Classifier pathExists) {
+    this->isCommand = isCommand;
+    this->isPrefixCommand = isPrefixCommand;
+    this->pathExists = pathExists;
+    reset();
+}
+
+void SyntaxHighlighter::setCommandPrefix(const std::string& prefix) {
+    if (prefix != commandPrefix) {
+        commandPrefix = prefix;
+        reset();
+    }
+}
+
+void SyntaxHighlighter::setShellMode(bool enabled) {
+    if (enabled != shellMode) {
+        shellMode = enabled;
+        reset();
+    }
+}
+
+void SyntaxHighlighter::reset() {
+    line.clear();
+    tokens.clear();
+}
+
+void SyntaxHighlighter::update(const std::string& newLine) {
+    if (newLine == line) {
+        return;
+    }
+    size_t prefixSame = 0;
+    if (initialState(newLine) == initialState(line)) {
+        while (prefixSame < line.size() && prefixSame < newLine.size() && line[prefixSame] == newLine[prefixSame]) {
+            prefixSame++;
+        }
+    }
+    size_t suffixLimit = std::min(line.size(), newLine.size()) - prefixSame;
+    size_t suffixSame = 0;
+    while (suffixSame < suffixLimit && line[line.size() - 1 - suffixSame] == newLine[newLine.size() - 1 - suffixSame]) {
+        suffixSame++;
+    }
+    size_t unchangedFrom = newLine.size() - suffixSame;
+
+    auto firstChanged = std::partition_point(tokens.begin(), tokens.end(), [prefixSame](const Token& token) {
+        return token.start + token.length < prefixSame;
+    });
+    size_t kept = firstChanged - tokens.begin();
+    std::vector<Token> oldTokens;
+    oldTokens.swap(tokens);
+    tokens.assign(oldTokens.begin(), oldTokens.begin() + kept);
+
+    size_t position = kept == 0 ? 0 : tokens.back().start + tokens.back().length;
+    LexState state = kept == 0 ? initialState(newLine) : tokens.back().nextState;
+    Token token;
+    while (scanToken(newLine, position, state, token)) {
+        if (token.start >= unchangedFrom) {
+            size_t oldStart = token.start + line.size() - newLine.size();
+            auto reuse = std::partition_point(oldTokens.begin() + kept, oldTokens.end(), [oldStart](const Token& old) {
+                return old.start < oldStart;
+            });
+            if (reuse != oldTokens.end() && reuse->start == oldStart && reuse->state == token.state) {
+                for (; reuse != oldTokens.end(); ++reuse) {
+                    Token shifted = *reuse;
+                    shifted.start = shifted.start + newLine.size() - line.size();
+                    tokens.push_back(shifted);
+                }
+                break;
+            }
+        }
+        if (token.type != TokenType::Operator) {
+            token.type = classify(newLine.substr(token.start, token.length), token.state);
+        }
+        tokens.push_back(token);
+        position = token.start + token.length;
+        state = token.nextState;
+    }
+    line = newLine;
+}
+
+std::string SyntaxHighlighter::render(size_t from, size_t to) const {
+    to = std::min(to, line.size());
+    std::string output;
+    if (from >= to) {
+        return output;
+    }
+    size_t position = from;
+    auto it = std::partition_point(tokens.begin(), tokens.end(), [from](const Token& token) {
+        return token.start + token.length <= from;
+    });
+    for (; it != tokens.end() && it->start < to; ++it) {
+        size_t start = std::max(it->start, from);
+        size_t end = std::min(it->start + it->length, to);
+        if (start > position) {
+            output.append(line, position, start - position);
+        }
+        std::string color = colorFor(it->type);
+        if (color.empty()) {
+            output.append(line, start, end - start);
+        } else {
+            output += color;
+            output.append(line, start, end - start);
+            output += "\033[0m";
+        }
+        position = end;
+    }
+    if (position < to) {
+        output.append(line, position, to - position);
+    }
+    return output;
+}
+
+const std::vector<SyntaxHighlighter::Token>& SyntaxHighlighter::getTokens() const {
+    return tokens;
+}
+
+SyntaxHighlighter::LexState SyntaxHighlighter::initialState(const std::string& text) const {
+    if (!commandPrefix.empty() && text.compare(0, commandPrefix.size(), commandPrefix) == 0) {
+        return LexState::PrefixCommandPosition;
+    }
+    return shellMode ? LexState::CommandPosition : LexState::Plain;
+}
+
+bool SyntaxHighlighter::scanToken(const std::string& text, size_t position, LexState state, Token& token) const {
+    if (state == LexState::Plain) {
+        return false;
+    }
+    while (position < text.size() && (text[position] == ' ' || text[position] == '\t')) {
+        position++;
+    }
+    if (position >= text.size()) {
+        return false;
+    }
+    token.start = position;
+    token.state = state;
+    char c = text[position];
+    if (isOperatorCharacter(c)) {
+        size_t end = position + 1;
+        if (end < text.size() && text[end] == c && c != ';') {
+            end++;
+        }
+        token.length = end - position;
+        token.type = TokenType::Operator;
+        token.nextState = (c == '<' || c == '>') ? LexState::ArgumentPosition : LexState::CommandPosition;
+        return true;
+    }
+    size_t end = position;
+    if (state == LexState::PrefixCommandPosition) {
+        end += commandPrefix.size();
+    }
+    bool assignment = false;
+    while (end < text.size() && text[end] != ' ' && text[end] != '\t' && !isOperatorCharacter(text[end])) {
+        char current = text[end];
+        if (current == '\\') {
+            end = std::min(end + 2, text.size());
+        } else if (current == '"' || current == '\'') {
+            size_t closing = end + 1;
+            while (closing < text.size() && text[closing] != current) {
+                closing += (current == '"' && text[closing] == '\\') ? 2 : 1;
+            }
+            end = std::min(closing + 1, text.size());
+        } else {
+            assignment = assignment || (current == '=' && end > position);
+            end++;
+        }
+    }
+    token.length = end - position;
+    token.type = TokenType::Argument;
+    if (state == LexState::PrefixCommandPosition) {
+        bool passthrough = text.compare(position + commandPrefix.size(), token.length - commandPrefix.size(), "terminal") == 0;
+        token.nextState = passthrough ? LexState::CommandPosition : LexState::ArgumentPosition;
+    } else if (state == LexState::CommandPosition && assignment) {
+        token.nextState = LexState::CommandPosition;
+    } else {
+        token.nextState = LexState::ArgumentPosition;
+    }
+    return true;
+}
+
+SyntaxHighlighter::TokenType SyntaxHighlighter::classify(const std::string& word, LexState state) const {
+    if (state == LexState::PrefixCommandPosition) {
+        std::string name = word.substr(commandPrefix.size());
+        return isPrefixCommand != nullptr && isPrefixCommand(name) ? TokenType::PrefixCommand : TokenType::InvalidPrefixCommand;
+    }
+    if (word[0] == '"' || word[0] == '\'') {
+        return TokenType::String;
+    }
+    if (state == LexState::CommandPosition) {
+        if (word.find('=') != std::string::npos && word[0] != '=') {
+            return TokenType::Argument;
+        }
+        return isCommand != nullptr && isCommand(word) ? TokenType::Command : TokenType::InvalidCommand;
+    }
+    if (word[0] == '-') {
+        return TokenType::Flag;
+    }
+    if (pathExists != nullptr && pathExists(word)) {
+        return TokenType::ExistingPath;
+    }
+    return TokenType::Argument;
+}
+
+bool SyntaxHighlighter::isOperatorCharacter(char c) {
+    return c == '|' || c == '&' || c == ';' || c == '<' || c == '>';
+}
+
+std::string SyntaxHighlighter::colorFor(TokenType type) {
+    switch (type) {
+        case TokenType::Command:
+            return "\033[1;32m";
+        case TokenType::InvalidCommand:
+        case TokenType::InvalidPrefixCommand:
+            return "\033[1;31m";
+        case TokenType::PrefixCommand:
+            return "\033[1;35m";
+        case TokenType::String:
+            return "\033[33m";
+        case TokenType::Flag:
+            return "\033[36m";
+        case TokenType::ExistingPath:
+            return "\033[4m";
+        case TokenType::Operator:
+            return "\033[1m";
+        default:
+            return "";
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef SYNTAXHIGHLIGHTER_H
+#define SYNTAXHIGHLIGHTER_H
+#include <string>
+#include <vector>
+
+class SyntaxHighlighter {
+public:
+    typedef bool (*Classifier)(const std::string& word);
+
+    enum class LexState { CommandPosition, PrefixCommandPosition, ArgumentPosition, Plain };
+    enum class TokenType { Command, InvalidCommand, PrefixCommand, InvalidPrefixCommand, String, Flag, ExistingPath, Operator, Argument };
+
+    struct Token {
+        size_t start;
+        size_t length;
+        LexState state;
+        LexState nextState;
+        TokenType type;
+    };
+
+    SyntaxHighlighter();
+
+    void setClassifiers(Classifier isCommand, Classifier isPrefixCommand, Classifier pathExists);
+    void setCommandPrefix(const std::string& prefix);
+    void setShellMode(bool enabled);
+    void reset();
+    void update(const std::string& newLine);
+    std::string render(size_t from, size_t to) const;
+    const std::vector<Token>& getTokens() const;
+
+private:
+    LexState initialState(const std::string& text) const;
+    bool scanToken(const std::string& text, size_t position, LexState state, Token& token) const;
+    TokenType classify(const std::string& word, LexState state) const;
+    static bool isOperatorCharacter(char c);
+    static std::string colorFor(TokenType type);
+
+    std::string line;
+    std::vector<Token> tokens;
+    std::string commandPrefix = "!";
+    bool shellMode = true;
+    Classifier isCommand = nullptr;
+    Classifier isPrefixCommand = nullptr;
+    Classifier pathExists = nullptr;
+};
+
+#endif // SYNTAXHIGHLIGHTER_H
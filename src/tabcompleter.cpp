@@ -0,0 +1,232 @@
+#include "tabcompleter.h"
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <unistd.h>
+
+static bool startsWith(const std::string& str, const std::string& prefix) {
+    return str.size() >= prefix.size() && str.compare(0, prefix.size(), prefix) == 0;
+}
+
+static std::string sharedPrefix(const std::string& first, const std::string& last) {
+    size_t length = 0;
+    while (length < first.size() && length < last.size() && first[length] == last[length]) {
+        length++;
+    }
+    return first.substr(0, length);
+}
+
+TabCompleter::TabCompleter() : commandTrie(std::make_unique<TrieNode>()) {}
+
+CompletionResult TabCompleter::completeCommandName(const std::string& prefix) {
+    refreshCommandTrie();
+    CompletionResult result;
+    const TrieNode* node = commandTrie.get();
+    for (char c : prefix) {
+        auto it = node->children.find(c);
+        if (it == node->children.end()) {
+            return result;
+        }
+        node = it->second.get();
+    }
+    std::string current = prefix;
+    collectCommands(node, current, result);
+    result.commonPrefix = prefix;
+    while (!node->isCommand && node->children.size() == 1) {
+        result.commonPrefix += node->children.begin()->first;
+        node = node->children.begin()->second.get();
+    }
+    return result;
+}
+
+bool TabCompleter::isCommand(const std::string& name) {
+    refreshCommandTrie();
+    const TrieNode* node = commandTrie.get();
+    for (char c : name) {
+        auto it = node->children.find(c);
+        if (it == node->children.end()) {
+            return false;
+        }
+        node = it->second.get();
+    }
+    return node->isCommand;
+}
+
+CompletionResult TabCompleter::completePath(const std::string& currentDirectory, const std::string& partial) {
+    CompletionResult result;
+    size_t lastSlash = partial.find_last_of('/');
+    std::string directoryPart = lastSlash == std::string::npos ? "" : partial.substr(0, lastSlash + 1);
+    std::string baseName = lastSlash == std::string::npos ? partial : partial.substr(lastSlash + 1);
+
+    fs::path directory;
+    if (directoryPart.empty()) {
+        directory = currentDirectory;
+    } else if (directoryPart[0] == '/') {
+        directory = directoryPart;
+    } else if (startsWith(directoryPart, "~/") && std::getenv("HOME") != nullptr) {
+        directory = fs::path(std::getenv("HOME")) / directoryPart.substr(2);
+    } else {
+        directory = fs::path(currentDirectory) / directoryPart;
+    }
+
+    const DirectoryListing* listing = getDirectoryListing(directory);
+    if (listing == nullptr) {
+        return result;
+    }
+    const std::vector<std::string>& entries = startsWith(baseName, ".") ? listing->hiddenEntries : listing->visibleEntries;
+    auto first = std::lower_bound(entries.begin(), entries.end(), baseName);
+    auto last = std::partition_point(first, entries.end(), [&baseName](const std::string& entry) {
+        return startsWith(entry, baseName);
+    });
+    result.totalMatches = std::distance(first, last);
+    if (result.totalMatches == 0) {
+        return result;
+    }
+    for (auto it = first; it != last && result.matches.size() < MAX_LISTED_MATCHES; ++it) {
+        result.matches.push_back(directoryPart + *it);
+    }
+    result.commonPrefix = directoryPart + sharedPrefix(*first, *(last - 1));
+    return result;
+}
+
+CompletionResult TabCompleter::completeFromList(const std::vector<std::string>& candidates, const std::string& prefix) {
+    CompletionResult result;
+    std::vector<std::string> sorted;
+    for (const auto& candidate : candidates) {
+        if (startsWith(candidate, prefix)) {
+            sorted.push_back(candidate);
+        }
+    }
+    if (sorted.empty()) {
+        return result;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    result.totalMatches = sorted.size();
+    result.commonPrefix = sharedPrefix(sorted.front(), sorted.back());
+    if (sorted.size() > MAX_LISTED_MATCHES) {
+        sorted.resize(MAX_LISTED_MATCHES);
+    }
+    result.matches = sorted;
+    return result;
+}
+
+void TabCompleter::clearCache() {
+    directoryCache.clear();
+    cachedPathVariable.clear();
+    pathDirectories.clear();
+}
+
+void TabCompleter::refreshCommandTrie() {
+    const char* pathEnv = std::getenv("PATH");
+    std::string pathVariable = pathEnv ? pathEnv : "";
+    if (!pathDirectoriesChanged(pathVariable)) {
+        return;
+    }
+    commandTrie = std::make_unique<TrieNode>();
+    cachedPathVariable = pathVariable;
+    pathDirectories.clear();
+    insertCommand("cd");
+    std::istringstream stream(pathVariable);
+    std::string directory;
+    while (std::getline(stream, directory, ':')) {
+        if (directory.empty()) {
+            continue;
+        }
+        std::error_code ec;
+        fs::file_time_type lastWriteTime = fs::last_write_time(directory, ec);
+        if (ec) {
+            continue;
+        }
+        pathDirectories.emplace_back(directory, lastWriteTime);
+        try {
+            for (const auto& entry : fs::directory_iterator(directory, fs::directory_options::skip_permission_denied)) {
+                if (entry.is_directory(ec)) {
+                    continue;
+                }
+                if (access(entry.path().c_str(), X_OK) == 0) {
+                    insertCommand(entry.path().filename().string());
+                }
+            }
+        } catch (const fs::filesystem_error& e) {
+            continue;
+        }
+    }
+}
+
+bool TabCompleter::pathDirectoriesChanged(const std::string& pathVariable) {
+    if (pathVariable != cachedPathVariable || pathDirectories.empty()) {
+        return true;
+    }
+    for (const auto& [directory, lastWriteTime] : pathDirectories) {
+        std::error_code ec;
+        if (fs::last_write_time(directory, ec) != lastWriteTime || ec) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TabCompleter::insertCommand(const std::string& command) {
+    TrieNode* node = commandTrie.get();
+    for (char c : command) {
+        auto& child = node->children[c];
+        if (!child) {
+            child = std::make_unique<TrieNode>();
+        }
+        node = child.get();
+    }
+    node->isCommand = true;
+}
+
+void TabCompleter::collectCommands(const TrieNode* node, std::string& current, CompletionResult& result) {
+    if (node->isCommand) {
+        result.totalMatches++;
+        if (result.matches.size() < MAX_LISTED_MATCHES) {
+            result.matches.push_back(current);
+        }
+    }
+    for (const auto& [c, child] : node->children) {
+        current.push_back(c);
+        collectCommands(child.get(), current, result);
+        current.pop_back();
+    }
+}
+
+const TabCompleter::DirectoryListing* TabCompleter::getDirectoryListing(const fs::path& directory) {
+    std::error_code ec;
+    fs::file_time_type lastWriteTime = fs::last_write_time(directory, ec);
+    if (ec) {
+        return nullptr;
+    }
+    std::string key = directory.lexically_normal().string();
+    auto cached = directoryCache.find(key);
+    if (cached != directoryCache.end() && cached->second.lastWriteTime == lastWriteTime) {
+        return &cached->second;
+    }
+    DirectoryListing listing;
+    listing.lastWriteTime = lastWriteTime;
+    try {
+        for (const auto& entry : fs::directory_iterator(directory, fs::directory_options::skip_permission_denied)) {
+            std::string name = entry.path().filename().string();
+            if (entry.is_directory(ec)) {
+                name += "/";
+            }
+            if (name[0] == '.') {
+                listing.hiddenEntries.push_back(name);
+            } else {
+                listing.visibleEntries.push_back(name);
+            }
+        }
+    } catch (const fs::filesystem_error& e) {
+        return nullptr;
+    }
+    std::sort(listing.visibleEntries.begin(), listing.visibleEntries.end());
+    std::sort(listing.hiddenEntries.begin(), listing.hiddenEntries.end());
+    if (cached == directoryCache.end() && directoryCache.size() >= MAX_CACHED_DIRECTORIES) {
+        directoryCache.clear();
+    }
+    DirectoryListing& stored = directoryCache[key];
+    stored = std::move(listing);
+    return &stored;
+}
@@ -0,0 +1,56 @@
+#ifndef TABCOMPLETER_H
+#define TABCOMPLETER_H
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+struct CompletionResult {
+    std::vector<std::string> matches;
+    size_t totalMatches = 0;
+    std::string commonPrefix;
+};
+
+class TabCompleter {
+public:
+    TabCompleter();
+
+    CompletionResult completeCommandName(const std::string& prefix);
+    bool isCommand(const std::string& name);
+    CompletionResult completePath(const std::string& currentDirectory, const std::string& partial);
+    static CompletionResult completeFromList(const std::vector<std::string>& candidates, const std::string& prefix);
+    void clearCache();
+
+    static const size_t MAX_LISTED_MATCHES = 100;
+
+private:
+    struct TrieNode {
+        std::map<char, std::unique_ptr<TrieNode>> children;
+        bool isCommand = false;
+    };
+
+    struct DirectoryListing {
+        fs::file_time_type lastWriteTime;
+        std::vector<std::string> visibleEntries;
+        std::vector<std::string> hiddenEntries;
+    };
+
+    std::unique_ptr<TrieNode> commandTrie;
+    std::string cachedPathVariable;
+    std::vector<std::pair<std::string, fs::file_time_type>> pathDirectories;
+    std::unordered_map<std::string, DirectoryListing> directoryCache;
+
+    const size_t MAX_CACHED_DIRECTORIES = 64;
+
+    void refreshCommandTrie();
+    bool pathDirectoriesChanged(const std::string& pathVariable);
+    void insertCommand(const std::string& command);
+    void collectCommands(const TrieNode* node, std::string& current, CompletionResult& result);
+    const DirectoryListing* getDirectoryListing(const fs::path& directory);
+};
+
+#endif // TABCOMPLETER_H
@@ -1,4 +1,5 @@
 #include "terminalpassthrough.h"
+#include <sys/wait.h>
 
 TerminalPassthrough::TerminalPassthrough() : displayWholePath(false) {
     currentDirectory = fs::current_path().string();
@@ -24,6 +25,28 @@ std::vector<std::string> TerminalPassthrough::getFilesAtCurrentPath(){
     return files;
 }
 
+std::vector<std::string> TerminalPassthrough::getFilesUnderCurrentPath(size_t limit){
+    std::vector<std::string> files;
+    fs::path root = getCurrentFilePath();
+    std::error_code ec;
+    fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec);
+    for (; it != fs::recursive_directory_iterator() && files.size() < limit; it.increment(ec)) {
+        if (ec) {
+            break;
+        }
+        if (it->path().filename().string().front() == '.') {
+            if (it->is_directory(ec)) {
+                it.disable_recursion_pending();
+            }
+            continue;
+        }
+        if (it->is_regular_file(ec)) {
+            files.push_back(it->path().lexically_relative(root).string());
+        }
+    }
+    return files;
+}
+
 void TerminalPassthrough::setDisplayWholePath(bool displayWholePath){
     this->displayWholePath = displayWholePath;
 }
@@ -89,6 +112,7 @@ std::string TerminalPassthrough::returnCurrentTerminalPosition(){
 
 std::thread TerminalPassthrough::executeCommand(std::string command){
     terminalCacheUserInput.push_back(command);
+    historyOffset = -1;
     return std::thread([this, command]() {
         try {
             std::string result;
@@ -114,15 +138,23 @@ std::thread TerminalPassthrough::executeCommand(std::string command){
                     }
                 }
                 result = "Changed directory to: " + currentDirectory;
+                lastExitStatus = 0;
             } else {
                 std::array<char, 128> buffer;
                 std::string fullCommand;
                 if (getTerminalName() == "cmd") {
                     fullCommand = "cd " + currentDirectory + " && " + command + " 2>&1";
                 } else {
-                    fullCommand = getTerminalName() + " -c \"cd " + currentDirectory + " && " + command + " 2>&1\"";
+                    fullCommand = getTerminalName() + " -c " + quote("cd " + quote(currentDirectory) + " && " + command + " 2>&1");
                 }
                 int terminalExecCode = std::system(fullCommand.c_str());
+                if (terminalExecCode == -1) {
+                    lastExitStatus = 127;
+                } else if (WIFEXITED(terminalExecCode)) {
+                    lastExitStatus = WEXITSTATUS(terminalExecCode);
+                } else {
+                    lastExitStatus = 128 + WTERMSIG(terminalExecCode);
+                }
                     if(terminalExecCode != 0){
                         std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(fullCommand.c_str(), "r"), pclose);
                         if (!pipe) {
@@ -137,11 +169,57 @@ std::thread TerminalPassthrough::executeCommand(std::string command){
             }
             terminalCacheTerminalOutput.push_back(result);
         } catch (const std::exception& e) {
+            lastExitStatus = 1;
             std::cerr << "Error executing command: '" << command << "' " << e.what() << std::endl;
         }
     });
 }
 
+int TerminalPassthrough::executeCapturedCommand(const std::string& command, const std::function<void(const std::string&)>& onLine) const {
+    std::string fullCommand = "cd \"" + currentDirectory + "\" && " + command + " 2>&1";
+    FILE* pipe = popen(fullCommand.c_str(), "r");
+    if (pipe == nullptr) {
+        return 127;
+    }
+    std::array<char, 4096> buffer;
+    std::string line;
+    while (fgets(buffer.data(), buffer.size(), pipe) != nullptr) {
+        line += buffer.data();
+        if (!line.empty() && line.back() == '\n') {
+            line.pop_back();
+            onLine(line);
+            line.clear();
+        }
+    }
+    if (!line.empty()) {
+        onLine(line);
+    }
+    int status = pclose(pipe);
+    if (status == -1) {
+        return 127;
+    }
+    if (WIFEXITED(status)) {
+        return WEXITSTATUS(status);
+    }
+    return 128 + WTERMSIG(status);
+}
+
+std::string TerminalPassthrough::quote(const std::string& text) {
+    std::string result = "'";
+    for (char c : text) {
+        if (c == '\'') {
+            result += "'\\''";
+        } else {
+            result += c;
+        }
+    }
+    return result + "'";
+}
+
+int TerminalPassthrough::getLastExitStatus(){
+    return lastExitStatus;
+}
+
 void TerminalPassthrough::toggleDisplayWholePath(){
     setDisplayWholePath(!displayWholePath);
 }
@@ -160,6 +238,7 @@ std::vector<std::string> TerminalPassthrough::getTerminalCacheTerminalOutput(){
 
 void TerminalPassthrough::clearTerminalCache(){
     terminalCacheUserInput.clear();
+    historyOffset = -1;
     terminalCacheTerminalOutput.clear();
 }
 
@@ -172,27 +251,66 @@ std::string TerminalPassthrough::returnMostRecentTerminalOutput(){
 }
 
 std::string TerminalPassthrough::getPreviousCommand() {
-    if (terminalCacheUserInput.empty()) {
+    std::string command;
+    if (historyOffset < 0) {
+        refreshPersistedHistory();
+    }
+    if (!getHistoryEntry(0, command)) {
         return "";
     }
-    if (commandHistoryIndex > 0) {
-        commandHistoryIndex--;
-    } else {
-        commandHistoryIndex = terminalCacheUserInput.size() - 1;
+    if (historyOffset >= 0 && getHistoryEntry(historyOffset + 1, command)) {
+        historyOffset++;
+        return command;
     }
-    return terminalCacheUserInput[commandHistoryIndex];
+    historyOffset = 0;
+    getHistoryEntry(historyOffset, command);
+    return command;
 }
 
 std::string TerminalPassthrough::getNextCommand() {
-    if (terminalCacheUserInput.empty()) {
+    std::string command;
+    if (!getHistoryEntry(0, command)) {
         return "";
     }
-    if (commandHistoryIndex < terminalCacheUserInput.size() - 1) {
-        commandHistoryIndex++;
+    if (historyOffset > 0) {
+        historyOffset--;
     } else {
-        commandHistoryIndex = 0;
+        historyOffset = getHistorySize() - 1;
+    }
+    getHistoryEntry(historyOffset, command);
+    return command;
+}
+
+void TerminalPassthrough::loadPersistedHistory(const fs::path& historyFile) {
+    persistedHistory.open(historyFile);
+    historyOffset = -1;
+}
+
+bool TerminalPassthrough::refreshPersistedHistory() {
+    if (!persistedHistory.refresh()) {
+        return false;
+    }
+    historyOffset = -1;
+    return true;
+}
+
+const MappedHistory& TerminalPassthrough::getPersistedHistory() const {
+    return persistedHistory;
+}
+
+bool TerminalPassthrough::getHistoryEntry(size_t offset, std::string& command) {
+    if (persistedHistory.isOpen()) {
+        return persistedHistory.getFromEnd(offset, command);
+    }
+    if (offset < terminalCacheUserInput.size()) {
+        command = terminalCacheUserInput[terminalCacheUserInput.size() - 1 - offset];
+        return true;
     }
-    return terminalCacheUserInput[commandHistoryIndex];
+    return false;
+}
+
+size_t TerminalPassthrough::getHistorySize() const {
+    return persistedHistory.isOpen() ? persistedHistory.size() : terminalCacheUserInput.size();
 }
 
 std::string TerminalPassthrough::getCurrentFilePath(){
@@ -217,4 +335,5 @@ bool TerminalPassthrough::isRootPath(const fs::path& path){
 
 void TerminalPassthrough::addCommandToHistory(const std::string& command) {
     terminalCacheUserInput.push_back(command);
+    historyOffset = -1;
 }
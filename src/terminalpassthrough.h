@@ -9,6 +9,8 @@
 #include <fstream>
 #include <stdexcept>
 #include <array>
+#include <functional>
+#include "mappedhistory.h"
 
 namespace fs = std::filesystem;
 
@@ -22,6 +24,7 @@ public:
     void printCurrentTerminalPosition();
 
     std::vector<std::string> getFilesAtCurrentPath();
+    std::vector<std::string> getFilesUnderCurrentPath(size_t limit);
     std::string getFullPathOfFile(const std::string& file);
     std::string getCurrentFilePath();
     void setDisplayWholePath(bool displayWholePath);
@@ -29,9 +32,14 @@ public:
     bool isDisplayWholePath();
 
     std::thread executeCommand(std::string command);
+    int executeCapturedCommand(const std::string& command, const std::function<void(const std::string&)>& onLine) const;
+    int getLastExitStatus();
     void addCommandToHistory(const std::string& command);
     std::string getPreviousCommand();
     std::string getNextCommand();
+    void loadPersistedHistory(const fs::path& historyFile);
+    bool refreshPersistedHistory();
+    const MappedHistory& getPersistedHistory() const;
 
     std::vector<std::string> getTerminalCacheUserInput();
     std::vector<std::string> getTerminalCacheTerminalOutput();
@@ -48,11 +56,16 @@ private:
     std::string RESET_COLOR = "\033[0m";
     std::string BLUE_COLOR_BOLD = "\033[1;34m";
     std::string YELLOW_COLOR_BOLD = "\033[1;33m";
-    int commandHistoryIndex = -1;
+    MappedHistory persistedHistory;
+    int historyOffset = -1;
+    int lastExitStatus = 0;
     int terminalCurrentPositionRawLength = 0;
 
     std::string getCurrentFileName();
     bool isRootPath(const fs::path& path);
+    static std::string quote(const std::string& text);
+    bool getHistoryEntry(size_t offset, std::string& command);
+    size_t getHistorySize() const;
 };
 
 #endif // TERMINALPASSTHROUGH_H
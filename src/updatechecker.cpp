@@ -0,0 +1,147 @@
+#include "updatechecker.h"
+#include "nlohmann/json.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using json = nlohmann::json;
+
+static const int REQUEST_TIMEOUT_SECONDS = 5;
+
+static std::string stripPrefix(const std::string& version) {
+    return !version.empty() && version[0] == 'v' ? version.substr(1) : version;
+}
+
+UpdateChecker::UpdateChecker(const std::string& url, const std::string& currentVersion, const std::filesystem::path& cacheFile, time_t ttlSeconds)
+    : url(url), currentVersion(currentVersion), cacheFile(cacheFile), ttlSeconds(ttlSeconds), state(std::make_shared<State>()) {}
+
+void UpdateChecker::start() {
+    time_t checked = 0;
+    std::string latestVersion;
+    if (readCache(cacheFile, checked, latestVersion) && time(nullptr) - checked < ttlSeconds) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->latestVersion = latestVersion;
+        state->finished = true;
+        return;
+    }
+    std::thread([state = state, url = url, cacheFile = cacheFile] {
+        std::string latestVersion;
+        if (!fetchLatestVersion(url, latestVersion)) {
+            return;
+        }
+        writeCache(cacheFile, time(nullptr), latestVersion);
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->latestVersion = latestVersion;
+        state->finished = true;
+    }).detach();
+}
+
+bool UpdateChecker::takeNotice(std::string& latestVersion) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (!state->finished || state->noticeShown || !isNewerVersion(state->latestVersion, currentVersion)) {
+        return false;
+    }
+    state->noticeShown = true;
+    latestVersion = state->latestVersion;
+    return true;
+}
+
+bool UpdateChecker::checkNow(std::string& latestVersion) {
+    if (!fetchLatestVersion(url, latestVersion)) {
+        return false;
+    }
+    writeCache(cacheFile, time(nullptr), latestVersion);
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->latestVersion = latestVersion;
+    state->finished = true;
+    state->noticeShown = true;
+    return true;
+}
+
+bool UpdateChecker::isNewerVersion(const std::string& latest, const std::string& current) {
+    auto splitVersion = [](const std::string& version) {
+        std::vector<int> parts;
+        std::istringstream stream(stripPrefix(version));
+        std::string token;
+        while (std::getline(stream, token, '.')) {
+            parts.push_back(std::atoi(token.c_str()));
+        }
+        return parts;
+    };
+    if (latest.empty()) {
+        return false;
+    }
+    std::vector<int> latestParts = splitVersion(latest);
+    std::vector<int> currentParts = splitVersion(current);
+    size_t length = std::max(latestParts.size(), currentParts.size());
+    latestParts.resize(length, 0);
+    currentParts.resize(length, 0);
+    for (size_t i = 0; i < length; i++) {
+        if (latestParts[i] != currentParts[i]) {
+            return latestParts[i] > currentParts[i];
+        }
+    }
+    return false;
+}
+
+bool UpdateChecker::readCache(const std::filesystem::path& file, time_t& checked, std::string& latestVersion) {
+    std::ifstream input(file);
+    if (!input.is_open()) {
+        return false;
+    }
+    try {
+        json cache;
+        input >> cache;
+        checked = static_cast<time_t>(cache.at("Checked").get<long long>());
+        latestVersion = cache.at("Latest_Version").get<std::string>();
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+void UpdateChecker::writeCache(const std::filesystem::path& file, time_t checked, const std::string& latestVersion) {
+    json cache;
+    cache["Checked"] = static_cast<long long>(checked);
+    cache["Latest_Version"] = latestVersion;
+    std::filesystem::path temporary = file;
+    temporary += ".tmp";
+    std::ofstream output(temporary, std::ios::trunc);
+    output << cache.dump();
+    output.close();
+    std::error_code ec;
+    if (output) {
+        std::filesystem::rename(temporary, file, ec);
+    } else {
+        std::filesystem::remove(temporary, ec);
+    }
+}
+
+bool UpdateChecker::fetchLatestVersion(const std::string& url, std::string& latestVersion) {
+    std::string command = "curl -s --max-time " + std::to_string(REQUEST_TIMEOUT_SECONDS) + " " + url + " 2>/dev/null";
+    FILE* pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr) {
+        return false;
+    }
+    std::string result;
+    char buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+        result.append(buffer, count);
+    }
+    pclose(pipe);
+    try {
+        json release = json::parse(result);
+        if (!release.contains("tag_name")) {
+            return false;
+        }
+        latestVersion = stripPrefix(release["tag_name"].get<std::string>());
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
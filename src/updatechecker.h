@@ -0,0 +1,38 @@
+#ifndef UPDATECHECKER_H
+#define UPDATECHECKER_H
+#include <string>
+#include <memory>
+#include <mutex>
+#include <ctime>
+#include <filesystem>
+
+class UpdateChecker {
+public:
+    UpdateChecker(const std::string& url, const std::string& currentVersion, const std::filesystem::path& cacheFile, time_t ttlSeconds);
+
+    void start();
+    bool takeNotice(std::string& latestVersion);
+    bool checkNow(std::string& latestVersion);
+
+    static bool isNewerVersion(const std::string& latest, const std::string& current);
+
+private:
+    struct State {
+        std::mutex mutex;
+        bool finished = false;
+        bool noticeShown = false;
+        std::string latestVersion;
+    };
+
+    static bool readCache(const std::filesystem::path& file, time_t& checked, std::string& latestVersion);
+    static void writeCache(const std::filesystem::path& file, time_t checked, const std::string& latestVersion);
+    static bool fetchLatestVersion(const std::string& url, std::string& latestVersion);
+
+    std::string url;
+    std::string currentVersion;
+    std::filesystem::path cacheFile;
+    time_t ttlSeconds;
+    std::shared_ptr<State> state;
+};
+
+#endif // UPDATECHECKER_H
@@ -0,0 +1,47 @@
+#include "workerpool.h"
+
+WorkerPool::WorkerPool(size_t maxThreads) : maxThreads(maxThreads == 0 ? 1 : maxThreads) {}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::submit(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push_back(std::move(task));
+    if (idle < tasks.size() && workers.size() < maxThreads) {
+        idle++;
+        workers.emplace_back(&WorkerPool::run, this);
+        return;
+    }
+    wake.notify_one();
+}
+
+size_t WorkerPool::getThreadCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return workers.size();
+}
+
+void WorkerPool::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+        idle--;
+        if (tasks.empty()) {
+            return;
+        }
+        std::function<void()> task = std::move(tasks.front());
+        tasks.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+        idle++;
+    }
+}
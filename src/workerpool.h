@@ -0,0 +1,32 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t maxThreads);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void submit(std::function<void()> task);
+    size_t getThreadCount();
+
+private:
+    void run();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wake;
+    size_t maxThreads;
+    size_t idle = 0;
+    bool stopping = false;
+};
+
+#endif // WORKERPOOL_H